@@ -0,0 +1,265 @@
+#include "BatchRenderer.hpp"
+#include <iostream>
+
+const juce::StringArray& RenderSettings::getKeys()
+{
+	static const juce::StringArray keys { "attack", "release", "ratio", "input-gain", "output-gain",
+		"all-buttons", "oversampling", "linear-phase", "split-rate", "link", "link-groups", "lookahead" };
+	return keys;
+}
+
+bool RenderSettings::isSwitch(const juce::String& key)
+{
+	return key == "all-buttons" || key == "linear-phase" || key == "split-rate";
+}
+
+juce::String RenderSettings::set(const juce::String& key, const juce::String& value)
+{
+	auto parseBool = [&value](bool& target) {
+		target = value.isEmpty() || value == "1" || value.equalsIgnoreCase("true") || value.equalsIgnoreCase("on");
+		return juce::String();
+	};
+	auto parseRange = [&key, &value](float& target, float min, float max) {
+		const float parsed = value.getFloatValue();
+		if (!value.containsOnly("-+.0123456789") || value.isEmpty() || parsed < min || parsed > max)
+			return key + " must be between " + juce::String(min) + " and " + juce::String(max);
+		target = parsed;
+		return juce::String();
+	};
+
+	if (key == "attack")
+		return parseRange(attack, 1.0f, 7.0f);
+	if (key == "release")
+		return parseRange(release, 1.0f, 7.0f);
+	if (key == "input-gain")
+		return parseRange(inputGain, -40.0f, 40.0f);
+	if (key == "output-gain")
+		return parseRange(outputGain, -40.0f, 40.0f);
+	if (key == "lookahead")
+		return parseRange(lookahead, 0.0f, Compressor1176::maxLookaheadMs);
+	if (key == "ratio")
+	{
+		// The gain computer has curves for the four buttons only
+		for (float choice : { 4.0f, 8.0f, 12.0f, 20.0f })
+			if (value.getFloatValue() == choice)
+			{
+				ratio = choice;
+				return {};
+			}
+		return "ratio must be 4, 8, 12 or 20";
+	}
+	if (key == "oversampling")
+	{
+		const int index = juce::StringArray { "1x", "2x", "4x", "8x" }.indexOf(value, true);
+		if (index < 0)
+			return "oversampling must be 1x, 2x, 4x or 8x";
+		oversamplingStages = index;
+		return {};
+	}
+	if (key == "link")
+	{
+		const int index = juce::StringArray { "dual-mono", "max", "sum" }.indexOf(value, true);
+		if (index < 0)
+			return "link must be dual-mono, max or sum";
+		link = static_cast<Compressor1176::LinkMode>(index);
+		return {};
+	}
+	if (key == "link-groups")
+	{
+		if (!value.containsOnly("0123456789, "))
+			return "link-groups must be a group number per channel, such as 1,1,1,0,2,2";
+		linkGroups = value;
+		return {};
+	}
+	if (key == "all-buttons")
+		return parseBool(allButtons);
+	if (key == "linear-phase")
+		return parseBool(linearPhase);
+	if (key == "split-rate")
+		return parseBool(splitRate);
+	return "unknown setting '" + key + "'";
+}
+
+juce::String RenderSettings::loadPreset(const juce::File& file)
+{
+	if (!file.existsAsFile())
+		return "preset " + file.getFullPathName() + " not found";
+
+	juce::StringArray lines;
+	file.readLines(lines);
+	for (int i = 0; i < lines.size(); ++i)
+	{
+		const auto line = lines[i].upToFirstOccurrenceOf("#", false, false).trim();
+		if (line.isEmpty())
+			continue;
+		const auto key = line.upToFirstOccurrenceOf("=", false, false).trim();
+		const auto value = line.fromFirstOccurrenceOf("=", false, false).trim();
+		const auto error = set(key, value);
+		if (error.isNotEmpty())
+			return file.getFileName() + ":" + juce::String(i + 1) + ": " + error;
+	}
+	return {};
+}
+
+// Before prepare(), so the gains start at their targets instead of ramping
+void RenderSettings::applyTo(Compressor1176& compressor) const
+{
+	compressor.setOversampling(oversamplingStages, linearPhase);
+	compressor.setSplitRateDetector(splitRate);
+	compressor.setAttack(attack);
+	compressor.setRelease(release);
+	compressor.setRatio(ratio);
+	compressor.setInputGain(inputGain);
+	compressor.setOutputGain(outputGain);
+	compressor.setAllButtons(allButtons);
+	compressor.setLinkMode(link);
+	if (linkGroups.isNotEmpty())
+		compressor.setLinkGroups(LinkGroups::fromString(linkGroups, Compressor1176::maxChannels));
+	compressor.setLookahead(lookahead);
+}
+
+//==============================================================================
+class BatchRenderer::Worker : public juce::ThreadPoolJob
+{
+	public:
+		explicit Worker(BatchRenderer& rendererToUse) : juce::ThreadPoolJob("1176 Batch Worker"), renderer(rendererToUse)
+		{
+			formats.registerBasicFormats();
+		}
+
+		JobStatus runJob() override
+		{
+			juce::ScopedNoDenormals noDenormals;
+			const auto& files = *renderer.queue;
+			for (int index = renderer.nextFile++; index < files.size() && !shouldExit(); index = renderer.nextFile++)
+			{
+				juce::String result;
+				const bool ok = renderer.renderFile(files[index], compressor, formats, block, result);
+				if (!ok)
+					++renderer.numFailed;
+				renderer.report("[" + juce::String(++renderer.numFinished) + "/" + juce::String(files.size()) + "] "
+					+ files[index].getFileName() + (ok ? ": " : ": FAILED, ") + result);
+			}
+			return jobHasFinished;
+		}
+
+	private:
+		BatchRenderer& renderer;
+		Compressor1176 compressor;
+		juce::AudioFormatManager formats;
+		juce::AudioBuffer<float> block;
+};
+
+BatchRenderer::BatchRenderer(const RenderSettings& settingsToUse, const juce::File& outputDirectoryToUse, int numWorkersToUse)
+	: settings(settingsToUse), outputDirectory(outputDirectoryToUse), numWorkers(juce::jmax(1, numWorkersToUse))
+{
+}
+
+int BatchRenderer::render(const juce::Array<juce::File>& files)
+{
+	if (files.isEmpty())
+		return 0;
+	queue = &files;
+	nextFile = 0;
+	numFinished = 0;
+	numFailed = 0;
+
+	const int poolSize = juce::jmin(numWorkers, files.size());
+	std::vector<std::unique_ptr<Worker>> workers;
+	juce::ThreadPool pool(poolSize);
+	for (int i = 0; i < poolSize; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>(*this));
+		pool.addJob(workers.back().get(), false);
+	}
+	for (auto& worker : workers)
+		pool.waitForJobToFinish(worker.get(), -1);
+
+	queue = nullptr;
+	return numFailed;
+}
+
+bool BatchRenderer::renderFile(const juce::File& input, Compressor1176& compressor, juce::AudioFormatManager& formats,
+	juce::AudioBuffer<float>& block, juce::String& result) const
+{
+	std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+	if (reader == nullptr)
+	{
+		result = "not a readable audio file";
+		return false;
+	}
+
+	const auto output = outputDirectory.getChildFile(input.getFileName());
+	if (output == input)
+	{
+		result = "output would overwrite the input";
+		return false;
+	}
+	auto* format = formats.findFormatForFileExtension(input.getFileExtension());
+	if (format == nullptr)
+	{
+		result = "no writer for " + input.getFileExtension();
+		return false;
+	}
+
+	const int numChannels = static_cast<int>(reader->numChannels);
+	const double sampleRate = reader->sampleRate;
+	const juce::int64 length = reader->lengthInSamples;
+
+	// Keep the bit depth when the format can write it, otherwise its best
+	int bitsPerSample = static_cast<int>(reader->bitsPerSample);
+	const auto depths = format->getPossibleBitDepths();
+	if (!depths.contains(bitsPerSample))
+		bitsPerSample = depths.getLast();
+
+	output.deleteFile();
+	std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+	if (stream == nullptr)
+	{
+		result = "cannot write " + output.getFullPathName();
+		return false;
+	}
+	std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+		static_cast<unsigned int>(numChannels), bitsPerSample, reader->metadataValues, 0));
+	if (writer == nullptr)
+	{
+		result = format->getFormatName() + " cannot write this channel count or rate";
+		return false;
+	}
+	stream.release();
+
+	settings.applyTo(compressor);
+	compressor.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) });
+	block.setSize(numChannels, blockSize, false, false, true);
+
+	// Past the end of the input the reader pads with silence, which flushes
+	// the latency out of the oversampler
+	juce::int64 latencyToSkip = compressor.getLatencySamples();
+	juce::int64 remaining = length;
+	const auto start = juce::Time::getMillisecondCounterHiRes();
+	for (juce::int64 position = 0; remaining > 0; position += blockSize)
+	{
+		reader->read(&block, 0, blockSize, position, true, true);
+		compressor.process(block);
+
+		const int skip = static_cast<int>(juce::jmin<juce::int64>(latencyToSkip, blockSize));
+		const int toWrite = static_cast<int>(juce::jmin<juce::int64>(blockSize - skip, remaining));
+		latencyToSkip -= skip;
+		if (toWrite > 0 && !writer->writeFromAudioSampleBuffer(block, skip, toWrite))
+		{
+			result = "write failed";
+			return false;
+		}
+		remaining -= toWrite;
+	}
+
+	const double seconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+	result = juce::String(length / sampleRate / juce::jmax(seconds, 1.0e-6), 1) + "x realtime";
+	return true;
+}
+
+void BatchRenderer::report(const juce::String& line)
+{
+	const juce::ScopedLock sl(reportLock);
+	std::cout << line << std::endl;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/Compressor1176.hpp"
+#include "../../Source/LinkGroups.hpp"
+
+// One parameter set for a whole batch, from a preset file and/or the
+// command line. Keys are the option names without the dashes:
+//   attack 1..7, release 1..7, ratio 4|8|12|20, input-gain dB,
+//   output-gain dB, all-buttons, oversampling 1x|2x|4x|8x, linear-phase,
+//   split-rate, link dual-mono|max|sum, link-groups (a group number per
+//   channel, 0 on its own; default all in one), lookahead 0..5 ms
+// Defaults are the plugin's.
+struct RenderSettings
+{
+	float attack = 4.0f;
+	float release = 4.0f;
+	float ratio = 4.0f;
+	float inputGain = 0.0f;
+	float outputGain = 0.0f;
+	bool allButtons = false;
+	int oversamplingStages = 2;
+	bool linearPhase = false;
+	bool splitRate = false;
+	Compressor1176::LinkMode link = Compressor1176::LinkMode::dualMono;
+	juce::String linkGroups;
+	float lookahead = 0.0f;
+
+	// Empty string on success, otherwise what was wrong
+	juce::String set(const juce::String& key, const juce::String& value);
+	// "key = value" (or a bare key for switches) per line, # starts a comment
+	juce::String loadPreset(const juce::File& file);
+
+	void applyTo(Compressor1176& compressor) const;
+
+	static const juce::StringArray& getKeys();
+	static bool isSwitch(const juce::String& key);
+};
+
+// Renders a list of files on a fixed pool of workers. Every worker owns
+// its compressor, format manager and one block of audio and pulls the next
+// file from a shared index, so memory is bounded by the worker count and
+// workers never wait on each other.
+class BatchRenderer
+{
+	public:
+		BatchRenderer(const RenderSettings& settings, const juce::File& outputDirectory, int numWorkers);
+
+		// Returns the number of files that failed
+		int render(const juce::Array<juce::File>& files);
+
+	private:
+		class Worker;
+
+		// Streams input to output through compressor, block by block. The
+		// output has the input's length, with the oversampler latency removed.
+		bool renderFile(const juce::File& input, Compressor1176& compressor, juce::AudioFormatManager& formats,
+			juce::AudioBuffer<float>& block, juce::String& result) const;
+		void report(const juce::String& line);
+
+		static constexpr int blockSize = 4096;
+
+		RenderSettings settings;
+		juce::File outputDirectory;
+		int numWorkers;
+
+		const juce::Array<juce::File>* queue = nullptr;
+		std::atomic<int> nextFile { 0 };
+		std::atomic<int> numFinished { 0 };
+		std::atomic<int> numFailed { 0 };
+		juce::CriticalSection reportLock;
+};
@@ -0,0 +1,88 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "BatchRenderer.hpp"
+
+static void printUsage()
+{
+	std::cout << "usage: 1176Batch [options] --output <directory> <file>...\n"
+		"\n"
+		"Renders each WAV/AIFF/FLAC file through the compressor into <directory>,\n"
+		"same name and format, latency removed.\n"
+		"\n"
+		"  -o, --output <dir>         where the results go (created if missing)\n"
+		"  -j, --jobs <n>             worker threads (default: one per core)\n"
+		"  --preset <file>            settings file, one \"key = value\" per line;\n"
+		"                             options on the command line override it\n"
+		"  --attack <1..7>            --release <1..7>\n"
+		"  --ratio <4|8|12|20>        --all-buttons\n"
+		"  --input-gain <dB>          --output-gain <dB>\n"
+		"  --oversampling <1x|2x|4x|8x>  --linear-phase  --split-rate\n"
+		"  --link <dual-mono|max|sum>  one detector per link group\n"
+		"  --link-groups <list>       group number per channel, 0 on its own\n"
+		"                             (1,1,1,0,2,2); default all in one group\n"
+		"  --lookahead <0..5>         ms, added to the removed latency\n";
+}
+
+int main(int argc, char* argv[])
+{
+	RenderSettings settings;
+	juce::StringPairArray overrides;
+	juce::File presetFile, outputDirectory;
+	juce::Array<juce::File> files;
+	int numWorkers = juce::SystemStats::getNumCpus();
+
+	const auto cwd = juce::File::getCurrentWorkingDirectory();
+	for (int i = 1; i < argc; ++i)
+	{
+		const juce::String arg = juce::String(argv[i]);
+		const auto key = arg.trimCharactersAtStart("-").upToFirstOccurrenceOf("=", false, false);
+		auto takeValue = [&]() -> juce::String {
+			if (arg.contains("="))
+				return arg.fromFirstOccurrenceOf("=", false, false);
+			return i + 1 < argc ? juce::String(argv[++i]) : juce::String();
+		};
+
+		if (arg == "-h" || arg == "--help")
+		{
+			printUsage();
+			return 0;
+		}
+		if (!arg.startsWith("-"))
+			files.add(cwd.getChildFile(arg));
+		else if (key == "o" || key == "output")
+			outputDirectory = cwd.getChildFile(takeValue());
+		else if (key == "j" || key == "jobs")
+			numWorkers = takeValue().getIntValue();
+		else if (key == "preset")
+			presetFile = cwd.getChildFile(takeValue());
+		else if (RenderSettings::getKeys().contains(key))
+			overrides.set(key, RenderSettings::isSwitch(key) && !arg.contains("=") ? juce::String() : takeValue());
+		else
+		{
+			std::cerr << "unknown option " << arg << "\n";
+			return 2;
+		}
+	}
+
+	if (files.isEmpty() || outputDirectory == juce::File())
+	{
+		printUsage();
+		return 2;
+	}
+
+	juce::String error = presetFile == juce::File() ? juce::String() : settings.loadPreset(presetFile);
+	for (int i = 0; i < overrides.size() && error.isEmpty(); ++i)
+		error = settings.set(overrides.getAllKeys()[i], overrides.getAllValues()[i]);
+	if (error.isEmpty() && numWorkers < 1)
+		error = "jobs must be at least 1";
+	if (error.isEmpty() && outputDirectory.createDirectory().failed())
+		error = "cannot create " + outputDirectory.getFullPathName();
+	if (error.isNotEmpty())
+	{
+		std::cerr << error << "\n";
+		return 2;
+	}
+
+	BatchRenderer renderer(settings, outputDirectory, numWorkers);
+	return renderer.render(files) == 0 ? 0 : 1;
+}
@@ -0,0 +1,344 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "Compressor1176.hpp"
+#include "LinkGroups.hpp"
+
+// Microbenchmark for Compressor1176::process(). Every combination of the
+// listed block sizes, sample rates, channel counts, ratios and All-Buttons
+// settings runs the same seeded programme material: a 110 Hz tone and
+// noise, stepping between -6 and -20 dBFS every 250 ms so attack and
+// release both run, driven 12 dB into the compressor. After a warm-up pass
+// the median of several timed passes is reported as ns per sample (per
+// channel) and as a real-time factor. --precision runs the same cases on
+// the double-precision engine as well, or instead.
+//
+// --json writes the results; --baseline compares against an earlier
+// --json file and exits with 1 if any case got slower than --threshold
+// percent, so a change to the engine can be checked with numbers.
+
+namespace
+{
+	struct Options
+	{
+		juce::Array<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+		juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+		juce::Array<int> channelCounts { 1, 2, 6 };
+		juce::Array<float> ratios { 4.0f, 8.0f, 12.0f, 20.0f };
+		juce::Array<bool> allButtons { false, true };
+		juce::Array<bool> doublePrecision { false };
+		int oversamplingStages = 2;
+		bool linearPhase = false;
+		bool splitRate = false;
+		Compressor1176::LinkMode link = Compressor1176::LinkMode::dualMono;
+		// As LinkGroups::fromString() reads it; empty links every channel
+		juce::String linkGroups;
+		float lookahead = 0.0f;
+		int passes = 5;
+		double seconds = 1.0;
+		juce::File jsonFile, baselineFile;
+		double threshold = 10.0;
+	};
+
+	struct Case
+	{
+		int blockSize;
+		double sampleRate;
+		int numChannels;
+		float ratio;
+		bool allButtons;
+		bool doublePrecision;
+
+		// Float cases keep the keys they had before there was a choice
+		juce::String getKey() const
+		{
+			return "b" + juce::String(blockSize) + "_r" + juce::String(juce::roundToInt(sampleRate))
+				+ "_c" + juce::String(numChannels) + "_ratio" + juce::String(juce::roundToInt(ratio))
+				+ (allButtons ? "_ab" : "") + (doublePrecision ? "_double" : "");
+		}
+	};
+
+	struct Result
+	{
+		Case config;
+		double nsPerSample;
+		double realtimeFactor;
+	};
+
+	void printUsage()
+	{
+		std::cout << "usage: 1176Bench [options]\n"
+			"\n"
+			"  --block-sizes <list>     default 32,64,128,256,512,1024,2048,4096\n"
+			"  --rates <list>           default 44100,48000,96000,192000\n"
+			"  --channels <list>        default 1,2,6\n"
+			"  --ratios <list>          default 4,8,12,20\n"
+			"  --all-buttons <off|on|both>  default both\n"
+			"  --oversampling <1x|2x|4x|8x>  default 4x\n"
+			"  --linear-phase  --split-rate\n"
+			"  --link <dual-mono|max|sum>  default dual-mono\n"
+			"  --link-groups <list>     group number per channel, 0 on its own (1,1,1,0,2,2);\n"
+			"                           default every channel in one group\n"
+			"  --lookahead <ms>         0..5, default 0\n"
+			"  --precision <float|double|both>  default float\n"
+			"  --passes <n>             timed passes per case, median reported (default 5)\n"
+			"  --seconds <s>            programme length per pass (default 1)\n"
+			"  --quick                  block sizes 64,512,4096, rates 48000,192000, stereo, ratios 4,20\n"
+			"  --json <file>            write the results\n"
+			"  --baseline <file>        compare with an earlier --json file\n"
+			"  --threshold <percent>    slowdown that counts as a regression (default 10)\n";
+	}
+
+	template <typename T>
+	juce::Array<T> parseList(const juce::String& text)
+	{
+		juce::Array<T> values;
+		for (const auto& item : juce::StringArray::fromTokens(text, ",", ""))
+			if (item.trim().isNotEmpty())
+				values.add(static_cast<T>(item.trim().getDoubleValue()));
+		return values;
+	}
+
+	template <typename SampleType>
+	void fillProgramme(juce::AudioBuffer<SampleType>& programme, double sampleRate)
+	{
+		juce::Random random(1176);
+		const int stepLength = juce::roundToInt(sampleRate * 0.25);
+		const double phaseStep = juce::MathConstants<double>::twoPi * 110.0 / sampleRate;
+		for (int ch = 0; ch < programme.getNumChannels(); ++ch)
+		{
+			SampleType* samples = programme.getWritePointer(ch);
+			for (int i = 0; i < programme.getNumSamples(); ++i)
+			{
+				const float level = (i / stepLength) % 2 == 0 ? 0.5f : 0.1f;
+				const float tone = static_cast<float>(std::sin(phaseStep * i + ch));
+				samples[i] = static_cast<SampleType>(level * (0.8f * tone + 0.2f * (random.nextFloat() * 2.0f - 1.0f)));
+			}
+		}
+	}
+
+	template <typename SampleType>
+	Result runCase(const Case& config, const Options& options)
+	{
+		BasicCompressor1176<SampleType> compressor;
+		compressor.setOversampling(options.oversamplingStages, options.linearPhase);
+		compressor.setSplitRateDetector(options.splitRate);
+		compressor.setLinkMode(options.link);
+		if (options.linkGroups.isNotEmpty())
+			compressor.setLinkGroups(LinkGroups::fromString(options.linkGroups, config.numChannels));
+		compressor.setLookahead(options.lookahead);
+		compressor.setRatio(config.ratio);
+		compressor.setAllButtons(config.allButtons);
+		compressor.setAttack(4.0f);
+		compressor.setRelease(4.0f);
+		compressor.setInputGain(12.0f);
+		compressor.prepare({ config.sampleRate, static_cast<juce::uint32>(config.blockSize), static_cast<juce::uint32>(config.numChannels) });
+
+		const int numBlocks = juce::jmax(1, juce::roundToInt(config.sampleRate * options.seconds) / config.blockSize);
+		const int length = numBlocks * config.blockSize;
+		juce::AudioBuffer<SampleType> programme(config.numChannels, length);
+		juce::AudioBuffer<SampleType> block(config.numChannels, config.blockSize);
+		fillProgramme(programme, config.sampleRate);
+
+		// The copy in is part of every case, and small next to process()
+		SampleType checksum = 0;
+		auto pass = [&]() {
+			const auto start = juce::Time::getHighResolutionTicks();
+			for (int n = 0; n < numBlocks; ++n)
+			{
+				for (int ch = 0; ch < config.numChannels; ++ch)
+					block.copyFrom(ch, 0, programme, ch, n * config.blockSize, config.blockSize);
+				compressor.process(block);
+				checksum += block.getSample(0, 0);
+			}
+			return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+		};
+
+		pass();
+		std::vector<double> timings;
+		for (int i = 0; i < options.passes; ++i)
+			timings.push_back(pass());
+		std::sort(timings.begin(), timings.end());
+		const double median = timings[timings.size() / 2];
+
+		// Keeps the output live, so nothing above can be optimised away
+		if (!std::isfinite(checksum))
+			std::cerr << "non-finite output in " << config.getKey() << "\n";
+
+		return { config, 1.0e9 * median / (static_cast<double>(length) * config.numChannels), length / config.sampleRate / median };
+	}
+
+	Result runCase(const Case& config, const Options& options)
+	{
+		return config.doublePrecision ? runCase<double>(config, options) : runCase<float>(config, options);
+	}
+
+	juce::var toJson(const juce::Array<Result>& results, const Options& options)
+	{
+		juce::Array<juce::var> cases;
+		for (const auto& result : results)
+		{
+			auto* entry = new juce::DynamicObject();
+			entry->setProperty("key", result.config.getKey());
+			entry->setProperty("block_size", result.config.blockSize);
+			entry->setProperty("sample_rate", result.config.sampleRate);
+			entry->setProperty("channels", result.config.numChannels);
+			entry->setProperty("ratio", result.config.ratio);
+			entry->setProperty("all_buttons", result.config.allButtons);
+			entry->setProperty("double_precision", result.config.doublePrecision);
+			entry->setProperty("ns_per_sample", result.nsPerSample);
+			entry->setProperty("realtime_factor", result.realtimeFactor);
+			cases.add(juce::var(entry));
+		}
+
+		auto* root = new juce::DynamicObject();
+		root->setProperty("oversampling", juce::String(1 << options.oversamplingStages) + "x");
+		root->setProperty("linear_phase", options.linearPhase);
+		root->setProperty("split_rate", options.splitRate);
+		root->setProperty("link", juce::StringArray { "dual-mono", "max", "sum" }[static_cast<int>(options.link)]);
+		root->setProperty("link_groups", options.linkGroups);
+		root->setProperty("lookahead_ms", options.lookahead);
+		root->setProperty("passes", options.passes);
+		root->setProperty("results", cases);
+		return juce::var(root);
+	}
+
+	// Number of cases slower than the baseline by more than the threshold
+	int compareWithBaseline(const juce::Array<Result>& results, const Options& options)
+	{
+		const auto baseline = juce::JSON::parse(options.baselineFile);
+		const auto* baselineCases = baseline["results"].getArray();
+		if (baselineCases == nullptr)
+		{
+			std::cerr << "no results in " << options.baselineFile.getFullPathName() << "\n";
+			return 1;
+		}
+
+		std::map<juce::String, double> baselineNs;
+		for (const auto& entry : *baselineCases)
+			baselineNs[entry["key"].toString()] = static_cast<double>(entry["ns_per_sample"]);
+
+		int regressions = 0, compared = 0;
+		for (const auto& result : results)
+		{
+			const auto found = baselineNs.find(result.config.getKey());
+			if (found == baselineNs.end() || found->second <= 0.0)
+				continue;
+			++compared;
+			const double change = 100.0 * (result.nsPerSample - found->second) / found->second;
+			if (change > options.threshold)
+			{
+				++regressions;
+				std::cout << "REGRESSION " << result.config.getKey() << ": " << juce::String(found->second, 2)
+					<< " -> " << juce::String(result.nsPerSample, 2) << " ns/sample (+" << juce::String(change, 1) << "%)\n";
+			}
+		}
+		std::cout << compared << " cases compared with " << options.baselineFile.getFileName() << ", "
+			<< regressions << " slower by more than " << juce::String(options.threshold, 1) << "%\n";
+		return regressions;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	const auto cwd = juce::File::getCurrentWorkingDirectory();
+	for (int i = 1; i < argc; ++i)
+	{
+		const juce::String arg = juce::String(argv[i]);
+		const auto key = arg.trimCharactersAtStart("-").upToFirstOccurrenceOf("=", false, false);
+		auto takeValue = [&]() -> juce::String {
+			if (arg.contains("="))
+				return arg.fromFirstOccurrenceOf("=", false, false);
+			return i + 1 < argc ? juce::String(argv[++i]) : juce::String();
+		};
+
+		if (key == "h" || key == "help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (key == "block-sizes")
+			options.blockSizes = parseList<int>(takeValue());
+		else if (key == "rates")
+			options.sampleRates = parseList<double>(takeValue());
+		else if (key == "channels")
+			options.channelCounts = parseList<int>(takeValue());
+		else if (key == "ratios")
+			options.ratios = parseList<float>(takeValue());
+		else if (key == "all-buttons")
+		{
+			const auto value = takeValue();
+			options.allButtons = value == "on" ? juce::Array<bool> { true }
+				: value == "off" ? juce::Array<bool> { false } : juce::Array<bool> { false, true };
+		}
+		else if (key == "oversampling")
+			options.oversamplingStages = juce::jmax(0, juce::StringArray { "1x", "2x", "4x", "8x" }.indexOf(takeValue(), true));
+		else if (key == "linear-phase")
+			options.linearPhase = true;
+		else if (key == "split-rate")
+			options.splitRate = true;
+		else if (key == "link")
+			options.link = static_cast<Compressor1176::LinkMode>(juce::jmax(0,
+				juce::StringArray { "dual-mono", "max", "sum" }.indexOf(takeValue(), true)));
+		else if (key == "link-groups")
+			options.linkGroups = takeValue();
+		else if (key == "lookahead")
+			options.lookahead = juce::jlimit(0.0f, Compressor1176::maxLookaheadMs, takeValue().getFloatValue());
+		else if (key == "precision")
+		{
+			const auto value = takeValue();
+			options.doublePrecision = value == "double" ? juce::Array<bool> { true }
+				: value == "both" ? juce::Array<bool> { false, true } : juce::Array<bool> { false };
+		}
+		else if (key == "passes")
+			options.passes = juce::jmax(1, takeValue().getIntValue());
+		else if (key == "seconds")
+			options.seconds = juce::jmax(0.01, takeValue().getDoubleValue());
+		else if (key == "quick")
+		{
+			options.blockSizes = { 64, 512, 4096 };
+			options.sampleRates = { 48000.0, 192000.0 };
+			options.channelCounts = { 2 };
+			options.ratios = { 4.0f, 20.0f };
+		}
+		else if (key == "json")
+			options.jsonFile = cwd.getChildFile(takeValue());
+		else if (key == "baseline")
+			options.baselineFile = cwd.getChildFile(takeValue());
+		else if (key == "threshold")
+			options.threshold = takeValue().getDoubleValue();
+		else
+		{
+			std::cerr << "unknown option " << arg << "\n";
+			return 2;
+		}
+	}
+
+	juce::ScopedNoDenormals noDenormals;
+	std::cout << "block   rate  ch ratio AB  prec  ns/sample  x realtime\n";
+	juce::Array<Result> results;
+	for (int blockSize : options.blockSizes)
+		for (double sampleRate : options.sampleRates)
+			for (int numChannels : options.channelCounts)
+				for (float ratio : options.ratios)
+					for (bool allButtons : options.allButtons)
+						for (bool doublePrecision : options.doublePrecision)
+						{
+							const auto result = runCase({ blockSize, sampleRate, numChannels, ratio, allButtons, doublePrecision }, options);
+							results.add(result);
+							std::cout << juce::String(blockSize).paddedLeft(' ', 5) << juce::String(juce::roundToInt(sampleRate)).paddedLeft(' ', 7)
+								<< juce::String(numChannels).paddedLeft(' ', 4) << juce::String(juce::roundToInt(ratio)).paddedLeft(' ', 6)
+								<< (allButtons ? " on " : " off") << (doublePrecision ? "  f64" : "  f32")
+								<< juce::String(result.nsPerSample, 2).paddedLeft(' ', 11)
+								<< juce::String(result.realtimeFactor, 1).paddedLeft(' ', 12) << std::endl;
+						}
+
+	if (options.jsonFile != juce::File() && !options.jsonFile.replaceWithText(juce::JSON::toString(toJson(results, options))))
+	{
+		std::cerr << "cannot write " << options.jsonFile.getFullPathName() << "\n";
+		return 2;
+	}
+	if (options.baselineFile != juce::File())
+		return compareWithBaseline(results, options) == 0 ? 0 : 1;
+	return 0;
+}
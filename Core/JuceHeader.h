@@ -0,0 +1,12 @@
+/*
+    JuceHeader.h for the CMake targets (1176DSP and what links it). The
+    Projucer projects generate their own in JuceLibraryCode/; this one only
+    pulls in the GUI-free modules the DSP core is built against.
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <juce_dsp/juce_dsp.h>
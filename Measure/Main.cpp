@@ -0,0 +1,388 @@
+#include <JuceHeader.h>
+#include <iostream>
+#include "Measurements.hpp"
+
+// Offline measurements of Compressor1176 against ReferenceCompressor, the
+// frozen double-precision model of the baseline algorithm:
+//   static curve         output level of a 1 kHz tone, -40..+10 dBFS in
+//   timing               attack and release of the GR at knobs 1, 4 and 7
+//   distortion           THD and aliasing of tones at -10 dBFS
+//   frequency response   third-octave tones, below and above threshold
+//   null tests           engine minus reference for a sine, a sweep, tone
+//                        bursts and noise, with the reference taking on the
+//                        engine's deliberate departures, and minus the
+//                        baseline for information
+//   tables               the tabulated gain curves, FET table and soft clip
+//                        against the exact ones
+// Exits with 1 when any null is shallower than --null-threshold or a table is
+// outside its documented accuracy, so a change to the hot loop can be checked
+// against the sound it is meant to keep.
+
+namespace
+{
+	struct Options
+	{
+		CompressorSettings settings;
+		double sampleRate = 48000.0;
+		int numChannels = 2;
+		int blockSize = 512;
+		double nullThresholdDb = -65.0;
+		bool doublePrecision = false;
+		juce::File jsonFile;
+	};
+
+	void printUsage()
+	{
+		std::cout << "usage: 1176Measure [options]\n"
+			"\n"
+			"  --rate <Hz>                 default 48000\n"
+			"  --block-size <n>            for everything but timing (default 512)\n"
+			"  --attack <1..7>             --release <1..7>\n"
+			"  --ratio <4|8|12|20>         --all-buttons\n"
+			"  --input-gain <dB>           --output-gain <dB>\n"
+			"  --oversampling <1x|2x|4x|8x>  --linear-phase  --split-rate\n"
+			"  --double                    measure the double-precision engine\n"
+			"  --null-threshold <dB>       shallowest null that passes (default -65)\n"
+			"  --json <file>               write the results\n";
+	}
+
+	juce::String formatDb(double value, int decimals = 2)
+	{
+		return std::isfinite(value) ? juce::String(value, decimals) : juce::String("n/a");
+	}
+
+	juce::String column(const juce::String& text, int width) { return text.paddedLeft(' ', width); }
+
+	// Output level of the last 100 ms, as the peak of the equivalent sine
+	double settledLevelDb(const juce::AudioBuffer<double>& buffer)
+	{
+		const int length = buffer.getNumSamples() / 5;
+		return Measurements::rmsDb(buffer.getReadPointer(0, buffer.getNumSamples() - length), length) + 3.0103;
+	}
+
+	juce::var measureStaticCurve(const Options& options)
+	{
+		std::cout << "\nStatic curve, 1 kHz\n   in dBFS   out dBFS    ref dBFS   diff dB\n";
+		juce::Array<juce::var> rows;
+		for (double levelDb = -40.0; levelDb <= 10.0; levelDb += 2.0)
+		{
+			const auto input = Measurements::makeSine(options.numChannels, options.sampleRate, 0.5, 1000.0, levelDb);
+			const double engine = settledLevelDb(Measurements::renderEngine(options.settings, options.sampleRate, input, options.blockSize,
+				nullptr, options.doublePrecision));
+			const double reference = settledLevelDb(Measurements::renderReference(options.settings, options.sampleRate, input, options.blockSize));
+			std::cout << column(juce::String(levelDb, 1), 11) << column(formatDb(engine), 11) << column(formatDb(reference), 12)
+				<< column(formatDb(engine - reference, 3), 10) << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("input_db", levelDb);
+			row->setProperty("output_db", engine);
+			row->setProperty("reference_db", reference);
+			rows.add(juce::var(row));
+		}
+		return rows;
+	}
+
+	// GR traced at one sample per block; the burst takes the detector from
+	// well below threshold to about 20 dB over it and back
+	juce::var measureTiming(const Options& options)
+	{
+		std::cout << "\nTiming, 1 kHz burst -40 -> -6 -> -40 dBFS, time to 63% of the settled GR\n"
+			"  knob   attack ms  (ref)   release ms  (ref)\n";
+		const double loudStart = 0.2, loudSeconds = 0.5;
+		const auto input = Measurements::makeToneBurst(1, options.sampleRate, 1000.0, -40.0, -6.0, loudStart, loudSeconds, 3.0);
+		const int start = juce::roundToInt(loudStart * options.sampleRate);
+		const int end = start + juce::roundToInt(loudSeconds * options.sampleRate);
+
+		juce::Array<juce::var> rows;
+		for (float knob : { 1.0f, 4.0f, 7.0f })
+		{
+			auto settings = options.settings;
+			settings.attack = settings.release = knob;
+			std::vector<double> engineTrace, referenceTrace;
+			Measurements::renderEngine(settings, options.sampleRate, input, 1, &engineTrace, options.doublePrecision);
+			Measurements::renderReference(settings, options.sampleRate, input, 1, &referenceTrace);
+			const auto engine = Measurements::measureTiming(engineTrace, options.sampleRate, start, end);
+			const auto reference = Measurements::measureTiming(referenceTrace, options.sampleRate, start, end);
+			std::cout << column(juce::String(knob, 0), 6) << column(formatDb(engine.attackMs, 3), 12) << column(formatDb(reference.attackMs, 3), 7)
+				<< column(formatDb(engine.releaseMs, 1), 13) << column(formatDb(reference.releaseMs, 1), 7) << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("knob", knob);
+			row->setProperty("attack_ms", engine.attackMs);
+			row->setProperty("release_ms", engine.releaseMs);
+			row->setProperty("reference_attack_ms", reference.attackMs);
+			row->setProperty("reference_release_ms", reference.releaseMs);
+			rows.add(juce::var(row));
+		}
+		return rows;
+	}
+
+	juce::var measureDistortion(const Options& options)
+	{
+		std::cout << "\nDistortion, -10 dBFS\n   freq Hz   THD dB   (ref)   aliasing dB   (ref)\n";
+		const int length = Measurements::getAnalysisLength(options.sampleRate);
+		juce::Array<juce::var> rows;
+		for (double frequency : { 100.0, 1000.0, 5000.0, 10000.0 })
+		{
+			if (frequency > 0.45 * options.sampleRate)
+				continue;
+			frequency = Measurements::binCentred(frequency, options.sampleRate, length);
+			// Half a second to settle, then one analysis window
+			const auto input = Measurements::makeSine(1, options.sampleRate, 0.5 + length / options.sampleRate, frequency, -10.0);
+			const auto engineOut = Measurements::renderEngine(options.settings, options.sampleRate, input, options.blockSize,
+				nullptr, options.doublePrecision);
+			const auto referenceOut = Measurements::renderReference(options.settings, options.sampleRate, input, options.blockSize);
+			const int from = input.getNumSamples() - length;
+			const auto engine = Measurements::measureDistortion(engineOut.getReadPointer(0, from), length, frequency, options.sampleRate);
+			const auto reference = Measurements::measureDistortion(referenceOut.getReadPointer(0, from), length, frequency, options.sampleRate);
+			std::cout << column(juce::String(frequency, 1), 10) << column(formatDb(engine.thdDb, 1), 9) << column(formatDb(reference.thdDb, 1), 8)
+				<< column(formatDb(engine.aliasingDb, 1), 14) << column(formatDb(reference.aliasingDb, 1), 8) << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("frequency", frequency);
+			row->setProperty("thd_db", engine.thdDb);
+			row->setProperty("aliasing_db", engine.aliasingDb);
+			row->setProperty("reference_thd_db", reference.thdDb);
+			row->setProperty("reference_aliasing_db", reference.aliasingDb);
+			rows.add(juce::var(row));
+		}
+		return rows;
+	}
+
+	juce::var measureFrequencyResponse(const Options& options)
+	{
+		std::cout << "\nFrequency response, dB re 1 kHz\n   freq Hz   -30 dBFS   (ref)   -6 dBFS   (ref)\n";
+		const int length = Measurements::getAnalysisLength(options.sampleRate);
+		auto gainAt = [&](double frequency, double levelDb, bool reference) {
+			const auto input = Measurements::makeSine(1, options.sampleRate, 0.3 + length / options.sampleRate, frequency, levelDb);
+			const auto output = reference ? Measurements::renderReference(options.settings, options.sampleRate, input, options.blockSize)
+				: Measurements::renderEngine(options.settings, options.sampleRate, input, options.blockSize, nullptr, options.doublePrecision);
+			const int from = input.getNumSamples() - length;
+			return 20.0 * std::log10(Measurements::amplitudeAt(output.getReadPointer(0, from), length, frequency, options.sampleRate)
+				/ Measurements::amplitudeAt(input.getReadPointer(0, from), length, frequency, options.sampleRate));
+		};
+
+		const double oneKilohertz = Measurements::binCentred(1000.0, options.sampleRate, length);
+		double normalise[2][2];
+		for (int reference = 0; reference < 2; ++reference)
+		{
+			normalise[reference][0] = gainAt(oneKilohertz, -30.0, reference != 0);
+			normalise[reference][1] = gainAt(oneKilohertz, -6.0, reference != 0);
+		}
+
+		juce::Array<juce::var> rows;
+		for (int band = -17; band <= 13; ++band)
+		{
+			const double nominal = 1000.0 * std::pow(2.0, band / 3.0);
+			if (nominal > 0.45 * options.sampleRate)
+				break;
+			const double frequency = Measurements::binCentred(nominal, options.sampleRate, length);
+			const double quiet = gainAt(frequency, -30.0, false) - normalise[0][0];
+			const double quietReference = gainAt(frequency, -30.0, true) - normalise[1][0];
+			const double loud = gainAt(frequency, -6.0, false) - normalise[0][1];
+			const double loudReference = gainAt(frequency, -6.0, true) - normalise[1][1];
+			std::cout << column(juce::String(frequency, 1), 10) << column(formatDb(quiet), 11) << column(formatDb(quietReference), 8)
+				<< column(formatDb(loud), 10) << column(formatDb(loudReference), 8) << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("frequency", frequency);
+			row->setProperty("quiet_db", quiet);
+			row->setProperty("loud_db", loud);
+			row->setProperty("reference_quiet_db", quietReference);
+			row->setProperty("reference_loud_db", loudReference);
+			rows.add(juce::var(row));
+		}
+		return rows;
+	}
+
+	juce::var measureNulls(const Options& options, int& numFailed)
+	{
+		std::cout << "\nNull tests against the reference with the engine's departures, pass at "
+			<< formatDb(options.nullThresholdDb, 1) << " dB or deeper\n"
+			<< "                                   null dB   vs baseline dB\n";
+		const double rate = options.sampleRate;
+		const int channels = options.numChannels;
+		const std::vector<std::pair<juce::String, juce::AudioBuffer<double>>> signals {
+			{ "sine 1 kHz -10 dBFS", Measurements::makeSine(channels, rate, 1.0, 1000.0, -10.0) },
+			{ "sweep 20 Hz-20 kHz -12 dBFS", Measurements::makeSweep(channels, rate, 3.0, 20.0, std::min(20000.0, 0.45 * rate), -12.0) },
+			{ "tone bursts 1 kHz -40/-6 dBFS", Measurements::makeToneBurst(channels, rate, 1000.0, -40.0, -6.0, 0.2, 0.5, 1.5) },
+			{ "noise -12 dBFS", Measurements::makeNoise(channels, rate, 2.0, -12.0, 1176) }
+		};
+
+		juce::Array<juce::var> rows;
+		for (const auto& [name, input] : signals)
+		{
+			const auto output = Measurements::renderEngine(options.settings, rate, input, options.blockSize, nullptr, options.doublePrecision);
+			const double depth = Measurements::nullDepthDb(output,
+				Measurements::renderReference(options.settings, rate, input, options.blockSize, nullptr, ReferenceCompressor::engineDepartures));
+			const double baselineDepth = Measurements::nullDepthDb(output,
+				Measurements::renderReference(options.settings, rate, input, options.blockSize));
+			const bool passed = depth <= options.nullThresholdDb;
+			numFailed += passed ? 0 : 1;
+			std::cout << "  " << name.paddedRight(' ', 32) << column(formatDb(depth, 1), 8) << column(formatDb(baselineDepth, 1), 17)
+				<< "  " << (passed ? "pass" : "FAIL") << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("signal", name);
+			row->setProperty("null_db", depth);
+			row->setProperty("baseline_null_db", baselineDepth);
+			row->setProperty("passed", passed);
+			rows.add(juce::var(row));
+		}
+		return rows;
+	}
+
+	// The float FET table against the per-instance table it replaced: the
+	// curve at FET_LOOKUP_SIZE points, read with cubicInterpolate()
+	double measureFETError()
+	{
+		std::vector<double> points(FET_LOOKUP_SIZE);
+		for (int i = 0; i < FET_LOOKUP_SIZE; ++i)
+			points[static_cast<size_t>(i)] = FETShaper::saturate(-2.0 + 4.0 * (i / static_cast<double>(FET_LOOKUP_SIZE - 1)), 0.5);
+
+		auto cubicInterpolate = [&](double x) {
+			x = std::clamp(x, -2.0, 2.0);
+			double index = (x + 2.0) / 4.0 * (FET_LOOKUP_SIZE - 1);
+			int i1 = static_cast<int>(index);
+			double frac = index - i1;
+			double y0 = points[static_cast<size_t>(std::max(0, i1 - 1))];
+			double y1 = points[static_cast<size_t>(i1)];
+			double y2 = points[static_cast<size_t>(std::min(i1 + 1, FET_LOOKUP_SIZE - 1))];
+			double y3 = points[static_cast<size_t>(std::min(i1 + 2, FET_LOOKUP_SIZE - 1))];
+			double a = (-0.5 * y0) + (1.5 * y1) - (1.5 * y2) + (0.5 * y3);
+			double b = y0 - (2.5 * y1) + (2.0 * y2) - (0.5 * y3);
+			double c = (-0.5 * y0) + (0.5 * y2);
+			return ((a * frac + b) * frac + c) * frac + y1;
+		};
+
+		double maxError = 0.0;
+		for (int n = -2400000; n <= 2400000; ++n)
+		{
+			const float x = static_cast<float>(n * 1.0e-6);
+			maxError = std::max(maxError, std::abs(FETShaper::lookup(x) - cubicInterpolate(x)));
+		}
+		return maxError;
+	}
+
+	double measureSoftClipError()
+	{
+		double maxError = 0.0;
+		for (int n = -1000000; n <= 1000000; ++n)
+		{
+			const float x = static_cast<float>(n * 1.0e-5);
+			maxError = std::max(maxError, std::abs(FETShaper::softClip(x) - ReferenceCompressor::softClip(x)));
+		}
+		return maxError;
+	}
+
+	// Each table against the function it stands in for, to the bound its
+	// header documents
+	juce::var measureTables(int& numFailed)
+	{
+		std::cout << "\nTables against the exact functions, pass within their documented bound\n";
+		juce::Array<juce::var> rows;
+		auto check = [&](const juce::String& name, double error, double bound, const juce::String& unit) {
+			const bool passed = error < bound;
+			numFailed += passed ? 0 : 1;
+			std::cout << "  " << name.paddedRight(' ', 32) << column(juce::String(error, 7), 10) << " " << unit
+				<< " (bound " << juce::String(bound) << ")  " << (passed ? "pass" : "FAIL") << "\n";
+
+			auto* row = new juce::DynamicObject();
+			row->setProperty("table", name);
+			row->setProperty("max_error", error);
+			row->setProperty("bound", bound);
+			row->setProperty("passed", passed);
+			rows.add(juce::var(row));
+		};
+
+		GainComputer gainComputer;
+		gainComputer.prepare();
+		check("gain curves, ratio buttons", gainComputer.measureMaxErrorDb(false), GainComputer::maxErrorDb, "dB");
+		check("gain curves, All-Buttons", gainComputer.measureMaxErrorDb(true), GainComputer::maxModulatedErrorDb, "dB");
+		check("FET table", measureFETError(), FETShaper::maxLookupError, "");
+		check("soft clip", measureSoftClipError(), FETShaper::maxSoftClipError, "");
+		return rows;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	auto& settings = options.settings;
+	const auto cwd = juce::File::getCurrentWorkingDirectory();
+	for (int i = 1; i < argc; ++i)
+	{
+		const juce::String arg = juce::String(argv[i]);
+		const auto key = arg.trimCharactersAtStart("-").upToFirstOccurrenceOf("=", false, false);
+		auto takeValue = [&]() -> juce::String {
+			if (arg.contains("="))
+				return arg.fromFirstOccurrenceOf("=", false, false);
+			return i + 1 < argc ? juce::String(argv[++i]) : juce::String();
+		};
+
+		if (key == "h" || key == "help")
+		{
+			printUsage();
+			return 0;
+		}
+		else if (key == "rate")
+			options.sampleRate = juce::jmax(8000.0, takeValue().getDoubleValue());
+		else if (key == "block-size")
+			options.blockSize = juce::jmax(1, takeValue().getIntValue());
+		else if (key == "attack")
+			settings.attack = takeValue().getFloatValue();
+		else if (key == "release")
+			settings.release = takeValue().getFloatValue();
+		else if (key == "ratio")
+			settings.ratio = takeValue().getFloatValue();
+		else if (key == "all-buttons")
+			settings.allButtons = true;
+		else if (key == "input-gain")
+			settings.inputGain = takeValue().getFloatValue();
+		else if (key == "output-gain")
+			settings.outputGain = takeValue().getFloatValue();
+		else if (key == "oversampling")
+			settings.oversamplingStages = juce::jmax(0, juce::StringArray { "1x", "2x", "4x", "8x" }.indexOf(takeValue(), true));
+		else if (key == "linear-phase")
+			settings.linearPhase = true;
+		else if (key == "split-rate")
+			settings.splitRate = true;
+		else if (key == "double")
+			options.doublePrecision = true;
+		else if (key == "null-threshold")
+			options.nullThresholdDb = takeValue().getDoubleValue();
+		else if (key == "json")
+			options.jsonFile = cwd.getChildFile(takeValue());
+		else
+		{
+			std::cerr << "unknown option " << arg << "\n";
+			return 2;
+		}
+	}
+
+	juce::ScopedNoDenormals noDenormals;
+	std::cout << "1176Measure: " << options.sampleRate << " Hz, ratio " << settings.ratio << (settings.allButtons ? " (All-Buttons)" : "")
+		<< ", attack " << settings.attack << ", release " << settings.release << ", " << (1 << settings.oversamplingStages) << "x"
+		<< (settings.linearPhase ? " linear phase" : "") << (settings.splitRate ? " split rate" : "")
+		<< (options.doublePrecision ? ", double precision" : "") << "\n";
+
+	int numFailed = 0;
+	auto* root = new juce::DynamicObject();
+	juce::var results(root);
+	root->setProperty("sample_rate", options.sampleRate);
+	root->setProperty("double_precision", options.doublePrecision);
+	root->setProperty("static_curve", measureStaticCurve(options));
+	root->setProperty("timing", measureTiming(options));
+	root->setProperty("distortion", measureDistortion(options));
+	root->setProperty("frequency_response", measureFrequencyResponse(options));
+	root->setProperty("null_tests", measureNulls(options, numFailed));
+	root->setProperty("tables", measureTables(numFailed));
+
+	if (options.jsonFile != juce::File() && !options.jsonFile.replaceWithText(juce::JSON::toString(results)))
+	{
+		std::cerr << "cannot write " << options.jsonFile.getFullPathName() << "\n";
+		return 2;
+	}
+	std::cout << "\n" << (numFailed == 0 ? juce::String("all checks pass") : juce::String(numFailed) + " check(s) FAILED") << "\n";
+	return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#include "Measurements.hpp"
+
+namespace Measurements
+{
+	static double toGain(double levelDb) { return std::pow(10.0, levelDb / 20.0); }
+
+	static juce::AudioBuffer<double> makeSignal(int numChannels, int length, const std::function<double(int)>& generate)
+	{
+		juce::AudioBuffer<double> signal(numChannels, length);
+		for (int i = 0; i < length; ++i)
+			signal.setSample(0, i, generate(i));
+		for (int ch = 1; ch < numChannels; ++ch)
+			signal.copyFrom(ch, 0, signal, 0, 0, length);
+		return signal;
+	}
+
+	juce::AudioBuffer<double> makeSine(int numChannels, double sampleRate, double seconds, double frequency, double levelDb)
+	{
+		const double amplitude = toGain(levelDb);
+		const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+		return makeSignal(numChannels, juce::roundToInt(seconds * sampleRate), [=](int i) { return amplitude * std::sin(omega * i); });
+	}
+
+	juce::AudioBuffer<double> makeSweep(int numChannels, double sampleRate, double seconds,
+		double startFrequency, double endFrequency, double levelDb)
+	{
+		const double amplitude = toGain(levelDb);
+		const double rate = std::log(endFrequency / startFrequency) / seconds;
+		const double scale = juce::MathConstants<double>::twoPi * startFrequency / rate;
+		return makeSignal(numChannels, juce::roundToInt(seconds * sampleRate), [=](int i) {
+			return amplitude * std::sin(scale * std::expm1(rate * i / sampleRate));
+		});
+	}
+
+	juce::AudioBuffer<double> makeToneBurst(int numChannels, double sampleRate, double frequency, double quietDb, double loudDb,
+		double loudStart, double loudSeconds, double quietSeconds)
+	{
+		const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+		const int start = juce::roundToInt(loudStart * sampleRate);
+		const int end = start + juce::roundToInt(loudSeconds * sampleRate);
+		const double quiet = toGain(quietDb), loud = toGain(loudDb);
+		return makeSignal(numChannels, end + juce::roundToInt(quietSeconds * sampleRate), [=](int i) {
+			return (i >= start && i < end ? loud : quiet) * std::sin(omega * i);
+		});
+	}
+
+	juce::AudioBuffer<double> makeNoise(int numChannels, double sampleRate, double seconds, double levelDb, juce::int64 seed)
+	{
+		juce::Random random(seed);
+		const double amplitude = toGain(levelDb);
+		juce::AudioBuffer<double> noise(numChannels, juce::roundToInt(seconds * sampleRate));
+		for (int ch = 0; ch < numChannels; ++ch)
+			for (int i = 0; i < noise.getNumSamples(); ++i)
+				noise.setSample(ch, i, amplitude * (2.0 * random.nextDouble() - 1.0));
+		return noise;
+	}
+
+	template <typename Sample, typename Processor>
+	static juce::AudioBuffer<double> render(Processor& processor, int latency, const juce::AudioBuffer<double>& input,
+		int blockSize, std::vector<double>* gainTrace)
+	{
+		const int numChannels = input.getNumChannels();
+		const int length = input.getNumSamples();
+		juce::AudioBuffer<Sample> block(numChannels, blockSize);
+		juce::AudioBuffer<double> output(numChannels, length);
+		if (gainTrace != nullptr)
+			gainTrace->clear();
+
+		// Silence past the end of the input flushes the latency out
+		for (int start = 0; start < length + latency; start += blockSize)
+		{
+			const int numSamples = std::min(blockSize, length + latency - start);
+			block.setSize(numChannels, numSamples, false, false, true);
+			for (int ch = 0; ch < numChannels; ++ch)
+				for (int i = 0; i < numSamples; ++i)
+					block.setSample(ch, i, start + i < length ? static_cast<Sample>(input.getSample(ch, start + i)) : Sample());
+
+			processor.process(block);
+			if (gainTrace != nullptr && start < length)
+				gainTrace->push_back(static_cast<double>(processor.getBlockMinGain(0)));
+
+			for (int ch = 0; ch < numChannels; ++ch)
+				for (int i = 0; i < numSamples; ++i)
+					if (start + i >= latency)
+						output.setSample(ch, start + i - latency, static_cast<double>(block.getSample(ch, i)));
+		}
+		return output;
+	}
+
+	template <typename SampleType>
+	static juce::AudioBuffer<double> renderEngine(const CompressorSettings& settings, double sampleRate,
+		const juce::AudioBuffer<double>& input, int blockSize, std::vector<double>* gainTrace)
+	{
+		BasicCompressor1176<SampleType> compressor;
+		settings.applyTo(compressor);
+		compressor.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(input.getNumChannels()) });
+		return render<SampleType>(compressor, compressor.getLatencySamples(), input, blockSize, gainTrace);
+	}
+
+	juce::AudioBuffer<double> renderEngine(const CompressorSettings& settings, double sampleRate,
+		const juce::AudioBuffer<double>& input, int blockSize, std::vector<double>* gainTrace, bool doublePrecision)
+	{
+		return doublePrecision ? renderEngine<double>(settings, sampleRate, input, blockSize, gainTrace)
+			: renderEngine<float>(settings, sampleRate, input, blockSize, gainTrace);
+	}
+
+	juce::AudioBuffer<double> renderReference(const CompressorSettings& settings, double sampleRate,
+		const juce::AudioBuffer<double>& input, int blockSize, std::vector<double>* gainTrace,
+		ReferenceCompressor::Departures departures)
+	{
+		ReferenceCompressor reference;
+		reference.prepare(settings, sampleRate, blockSize, input.getNumChannels(), departures);
+		return render<double>(reference, reference.getLatencySamples(), input, blockSize, gainTrace);
+	}
+
+	int getAnalysisLength(double sampleRate)
+	{
+		return 1 << juce::roundToInt(std::log2(sampleRate * 0.25));
+	}
+
+	double binCentred(double frequency, double sampleRate, int length)
+	{
+		const double binWidth = sampleRate / length;
+		return std::max(1.0, std::round(frequency / binWidth)) * binWidth;
+	}
+
+	double amplitudeAt(const double* samples, int length, double frequency, double sampleRate)
+	{
+		const double omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+		const double coeff = 2.0 * std::cos(omega);
+		double s1 = 0.0, s2 = 0.0;
+		for (int i = 0; i < length; ++i)
+		{
+			const double s0 = samples[i] + coeff * s1 - s2;
+			s2 = s1;
+			s1 = s0;
+		}
+		const double real = s1 - s2 * std::cos(omega);
+		const double imag = s2 * std::sin(omega);
+		return 2.0 * std::sqrt(real * real + imag * imag) / length;
+	}
+
+	double rmsDb(const double* samples, int length)
+	{
+		double sum = 0.0;
+		for (int i = 0; i < length; ++i)
+			sum += samples[i] * samples[i];
+		return 10.0 * std::log10(sum / std::max(1, length) + 1.0e-30);
+	}
+
+	double nullDepthDb(const juce::AudioBuffer<double>& output, const juce::AudioBuffer<double>& reference)
+	{
+		jassert(output.getNumChannels() == reference.getNumChannels() && output.getNumSamples() == reference.getNumSamples());
+		double residual = 0.0, power = 0.0;
+		for (int ch = 0; ch < reference.getNumChannels(); ++ch)
+			for (int i = 0; i < reference.getNumSamples(); ++i)
+			{
+				const double difference = output.getSample(ch, i) - reference.getSample(ch, i);
+				residual += difference * difference;
+				power += reference.getSample(ch, i) * reference.getSample(ch, i);
+			}
+		return 10.0 * std::log10((residual + 1.0e-30) / (power + 1.0e-30));
+	}
+
+	Distortion measureDistortion(const double* samples, int length, double frequency, double sampleRate)
+	{
+		const double nyquist = 0.5 * sampleRate;
+		const double halfBin = 0.5 * sampleRate / length;
+		const double fundamental = amplitudeAt(samples, length, frequency, sampleRate);
+
+		std::vector<double> inBand { frequency };
+		for (int k = 2; k <= 15 && k * frequency < nyquist - halfBin; ++k)
+			inBand.push_back(k * frequency);
+
+		double harmonicPower = 0.0, aliasPower = 0.0;
+		for (size_t k = 1; k < inBand.size(); ++k)
+			harmonicPower += std::pow(amplitudeAt(samples, length, inBand[k], sampleRate), 2.0);
+		for (int k = static_cast<int>(inBand.size()) + 1; k <= 15; ++k)
+		{
+			// Where the k-th harmonic lands after folding around multiples of Nyquist
+			const double folded = std::abs(k * frequency - sampleRate * std::round(k * frequency / sampleRate));
+			const bool onHarmonic = std::any_of(inBand.begin(), inBand.end(), [&](double f) { return std::abs(f - folded) < halfBin; });
+			if (!onHarmonic && folded > halfBin && folded < nyquist - halfBin)
+				aliasPower += std::pow(amplitudeAt(samples, length, folded, sampleRate), 2.0);
+		}
+
+		auto relativeDb = [fundamental](double power) { return 10.0 * std::log10(power / (fundamental * fundamental + 1.0e-30) + 1.0e-20); };
+		return { relativeDb(harmonicPower), relativeDb(aliasPower) };
+	}
+
+	Timing measureTiming(const std::vector<double>& gainTrace, double sampleRate, int loudStart, int loudEnd)
+	{
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		if (loudStart < 0 || loudEnd <= loudStart || loudEnd > static_cast<int>(gainTrace.size()))
+			return { nan, nan };
+
+		auto toDb = [](double gain) { return 20.0 * std::log10(std::max(gain, 1.0e-6)); };
+		// Settled GR: mean over the last fifth of the loud part, which
+		// averages out the detector ripple
+		const int settleFrom = loudEnd - (loudEnd - loudStart) / 5;
+		double settledDb = 0.0;
+		for (int i = settleFrom; i < loudEnd; ++i)
+			settledDb += toDb(gainTrace[static_cast<size_t>(i)]);
+		settledDb /= loudEnd - settleFrom;
+		if (settledDb > -0.1)
+			return { nan, nan };
+
+		const double fraction = 1.0 - std::exp(-1.0);
+		Timing timing { nan, nan };
+		for (int i = loudStart; i < loudEnd; ++i)
+			if (toDb(gainTrace[static_cast<size_t>(i)]) <= fraction * settledDb)
+			{
+				timing.attackMs = 1000.0 * (i - loudStart) / sampleRate;
+				break;
+			}
+		for (int i = loudEnd; i < static_cast<int>(gainTrace.size()); ++i)
+			if (toDb(gainTrace[static_cast<size_t>(i)]) >= (1.0 - fraction) * settledDb)
+			{
+				timing.releaseMs = 1000.0 * (i - loudEnd) / sampleRate;
+				break;
+			}
+		return timing;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <JuceHeader.h>
+#include "ReferenceCompressor.hpp"
+
+// Signals and analysis for the measurement harness. Everything runs in
+// double; the engine's float output is widened before it is analysed.
+namespace Measurements
+{
+	// Levels are peak dBFS. Every channel carries the same signal, except
+	// noise, which is independent per channel.
+	juce::AudioBuffer<double> makeSine(int numChannels, double sampleRate, double seconds, double frequency, double levelDb);
+	// Exponential sweep from startFrequency to endFrequency
+	juce::AudioBuffer<double> makeSweep(int numChannels, double sampleRate, double seconds,
+		double startFrequency, double endFrequency, double levelDb);
+	// Tone at quietDb, then loudDb from loudStart for loudSeconds, then
+	// quietDb again for quietSeconds
+	juce::AudioBuffer<double> makeToneBurst(int numChannels, double sampleRate, double frequency, double quietDb, double loudDb,
+		double loudStart, double loudSeconds, double quietSeconds);
+	juce::AudioBuffer<double> makeNoise(int numChannels, double sampleRate, double seconds, double levelDb, juce::int64 seed);
+
+	// Streams input through a fresh engine or reference in blocks of
+	// blockSize and returns an output of the same length, latency removed.
+	// gainTrace, if given, receives channel 0's lowest GR of every block.
+	// doublePrecision runs Compressor1176Double instead of the float engine.
+	juce::AudioBuffer<double> renderEngine(const CompressorSettings& settings, double sampleRate,
+		const juce::AudioBuffer<double>& input, int blockSize, std::vector<double>* gainTrace = nullptr,
+		bool doublePrecision = false);
+	// departures picks which of the engine's deliberate departures the
+	// reference takes on; none by default, so it renders the baseline
+	juce::AudioBuffer<double> renderReference(const CompressorSettings& settings, double sampleRate,
+		const juce::AudioBuffer<double>& input, int blockSize, std::vector<double>* gainTrace = nullptr,
+		ReferenceCompressor::Departures departures = {});
+
+	// Power-of-two analysis length of about a quarter second
+	int getAnalysisLength(double sampleRate);
+	// Nearest frequency with a whole number of cycles in length samples, so
+	// a rectangular window has no leakage
+	double binCentred(double frequency, double sampleRate, int length);
+	// Peak amplitude of the component at frequency (Goertzel)
+	double amplitudeAt(const double* samples, int length, double frequency, double sampleRate);
+	double rmsDb(const double* samples, int length);
+
+	// Residual of output minus reference relative to the reference, in dB
+	// over all channels; more negative is a deeper null
+	double nullDepthDb(const juce::AudioBuffer<double>& output, const juce::AudioBuffer<double>& reference);
+
+	// Harmonics 2..15 of a bin-centred tone, relative to the fundamental:
+	// those below Nyquist are THD, the ones folded back are aliasing
+	struct Distortion
+	{
+		double thdDb;
+		double aliasingDb;
+	};
+	Distortion measureDistortion(const double* samples, int length, double frequency, double sampleRate);
+
+	// Time for the GR, in dB, to cover 1 - 1/e of the way to its settled
+	// value after loudStart, and back towards 0 dB after loudEnd. NaN when
+	// it never gets there.
+	struct Timing
+	{
+		double attackMs;
+		double releaseMs;
+	};
+	Timing measureTiming(const std::vector<double>& gainTrace, double sampleRate, int loudStart, int loudEnd);
+}
@@ -0,0 +1,201 @@
+#include "ReferenceCompressor.hpp"
+
+template <typename SampleType>
+void CompressorSettings::applyTo(BasicCompressor1176<SampleType>& compressor) const
+{
+	compressor.setOversampling(oversamplingStages, linearPhase);
+	compressor.setSplitRateDetector(splitRate);
+	compressor.setAttack(attack);
+	compressor.setRelease(release);
+	compressor.setRatio(ratio);
+	compressor.setInputGain(inputGain);
+	compressor.setOutputGain(outputGain);
+	compressor.setAllButtons(allButtons);
+}
+
+template void CompressorSettings::applyTo(Compressor1176&) const;
+template void CompressorSettings::applyTo(Compressor1176Double&) const;
+
+//==============================================================================
+double ReferenceCompressor::fet(double x)
+{
+	// The baseline's table: saturate() at 1024 points over -2..2, read with
+	// Catmull-Rom and the end points repeated
+	static const std::vector<double> table = [] {
+		std::vector<double> points(1024);
+		for (size_t i = 0; i < points.size(); ++i)
+			points[i] = FETShaper::saturate(-2.0 + 4.0 * (static_cast<double>(i) / 1023.0), 0.5);
+		return points;
+	}();
+
+	const double index = (std::clamp(x, -2.0, 2.0) + 2.0) / 4.0 * 1023.0;
+	const int i1 = static_cast<int>(index);
+	const double frac = index - i1;
+	const double y0 = table[static_cast<size_t>(std::max(0, i1 - 1))];
+	const double y1 = table[static_cast<size_t>(i1)];
+	const double y2 = table[static_cast<size_t>(std::min(i1 + 1, 1023))];
+	const double y3 = table[static_cast<size_t>(std::min(i1 + 2, 1023))];
+	const double a = (-0.5 * y0) + (1.5 * y1) - (1.5 * y2) + (0.5 * y3);
+	const double b = y0 - (2.5 * y1) + (2.0 * y2) - (0.5 * y3);
+	const double c = (-0.5 * y0) + (0.5 * y2);
+	return a * frac * frac * frac + b * frac * frac + c * frac + y1;
+}
+
+double ReferenceCompressor::softClip(double x)
+{
+	const double magnitude = std::abs(x);
+	const double clipped = std::min(magnitude, 0.98) + 0.05 * std::tanh(std::max(magnitude - 0.98, 0.0));
+	return std::copysign(clipped, x);
+}
+
+double ReferenceCompressor::computeGain(double level, double thresholdDb, double ratio)
+{
+	const double levelDb = 20.0 * std::log10(level + 1.0e-12);
+	if (levelDb <= thresholdDb)
+		return 1.0;
+	const double gainReductionDb = std::clamp((levelDb - thresholdDb) * (1.0 - 1.0 / ratio), 0.0, 60.0);
+	return std::pow(10.0, -gainReductionDb / 20.0);
+}
+
+double ReferenceCompressor::coefficient(double timeMs) const
+{
+	return -std::expm1(-1.0 / (0.001 * timeMs * overSampledRate));
+}
+
+void ReferenceCompressor::prepare(const CompressorSettings& newSettings, double sampleRate, int maximumBlockSize, int numChannels,
+	Departures newDepartures)
+{
+	settings = newSettings;
+	departures = newDepartures;
+	const double attackKnob = std::clamp(static_cast<double>(settings.attack), 1.0, 7.0);
+	const double releaseKnob = std::clamp(static_cast<double>(settings.release), 1.0, 7.0);
+	attackMs = 0.8 + (attackKnob - 1.0) / 6.0 * (0.02 - 0.8);
+	releaseMs = 1100.0 + (releaseKnob - 1.0) / 6.0 * (50.0 - 1100.0);
+	inputGain = std::pow(10.0, (settings.inputGain + 12.0) / 20.0);
+	outputGain = std::pow(10.0, (settings.outputGain - 12.0) / 20.0);
+
+	const int stages = juce::jlimit(0, 3, settings.oversamplingStages);
+	overSampling = std::make_unique<juce::dsp::Oversampling<double>>(
+		static_cast<size_t>(numChannels),
+		static_cast<size_t>(stages),
+		settings.linearPhase ? juce::dsp::Oversampling<double>::filterHalfBandFIREquiripple
+			: juce::dsp::Oversampling<double>::filterHalfBandPolyphaseIIR,
+		true,
+		true);
+	overSampling->initProcessing(static_cast<size_t>(maximumBlockSize));
+	overSampledRate = sampleRate * static_cast<double>(overSampling->getOversamplingFactor());
+	latencySamples = juce::roundToInt(overSampling->getLatencyInSamples());
+
+	channels.assign(static_cast<size_t>(numChannels), Channel {});
+	ratioModulation = 0.0;
+	overSampling->reset();
+}
+
+void ReferenceCompressor::designShelves(Channel& state, double boostDb) const
+{
+	// juce::dsp::IIR::Coefficients::makeLowShelf / makeHighShelf, Q 0.707
+	const double a = std::pow(10.0, boostDb / 40.0);
+	const double aMinus1 = a - 1.0, aPlus1 = a + 1.0;
+	auto design = [&](double frequency, bool high, double* out) {
+		const double omega = juce::MathConstants<double>::twoPi * frequency / overSampledRate;
+		const double cosOmega = std::cos(omega);
+		const double beta = std::sin(omega) * std::sqrt(a) / 0.707;
+		const double sign = high ? -1.0 : 1.0;
+		const double b0 = a * (aPlus1 - sign * aMinus1 * cosOmega + beta);
+		const double b1 = sign * 2.0 * a * (aMinus1 - sign * aPlus1 * cosOmega);
+		const double b2 = a * (aPlus1 - sign * aMinus1 * cosOmega - beta);
+		const double a0 = aPlus1 + sign * aMinus1 * cosOmega + beta;
+		const double a1 = -sign * 2.0 * (aMinus1 + sign * aPlus1 * cosOmega);
+		const double a2 = aPlus1 + sign * aMinus1 * cosOmega - beta;
+		out[0] = b0 / a0;
+		out[1] = b1 / a0;
+		out[2] = b2 / a0;
+		out[3] = a1 / a0;
+		out[4] = a2 / a0;
+	};
+	design(100.0, false, state.shelves);
+	design(8000.0, true, state.shelves + 5);
+	state.lastBoostDb = boostDb;
+}
+
+double ReferenceCompressor::processSample(Channel& state, double input)
+{
+	double& modulation = departures.perChannelModulation ? state.modulation : ratioModulation;
+	double x = input * inputGain;
+	if (settings.allButtons)
+	{
+		const double absSample = std::abs(x);
+		const double fastCoeff = coefficient(0.5);
+		const double slowCoeff = coefficient(50.0);
+		state.fast = fastCoeff * absSample + (1.0 - fastCoeff) * state.fast;
+		state.slow = slowCoeff * absSample + (1.0 - slowCoeff) * state.slow;
+		const double transientRatio = state.fast / (state.slow + 1.0e-6);
+		modulation = transientRatio > 1.3
+			? std::clamp((transientRatio - 1.5) * 0.3, -0.5, 0.5)
+			: modulation * 0.995;
+		x = fet(x * 1.15);
+	}
+
+	const double gain = state.gainReduction;
+	state.blockMinGain = std::min(state.blockMinGain, gain);
+	x *= gain;
+	const double absSample = std::abs(x);
+	const double detectorCoeff = coefficient(absSample > state.envelope ? 0.02 : 1.5);
+	state.envelope = detectorCoeff * absSample + (1.0 - detectorCoeff) * state.envelope;
+	x = fet(x);
+
+	if (gain < 0.95)
+	{
+		const double boostDb = 1.0 - gain;
+		if (departures.continuousShelves || std::abs(boostDb - state.lastBoostDb) > 0.1)
+			designShelves(state, boostDb);
+		const double* c = state.shelves;
+		const double low = c[0] * x + state.lowZ1;
+		state.lowZ1 = c[1] * x - c[3] * low + state.lowZ2;
+		state.lowZ2 = c[2] * x - c[4] * low;
+		const double high = c[5] * low + state.highZ1;
+		state.highZ1 = c[6] * low - c[8] * high + state.highZ2;
+		state.highZ2 = c[7] * low - c[9] * high;
+		x = high;
+	}
+
+	double target, attack = attackMs, release = releaseMs;
+	if (settings.allButtons)
+	{
+		target = computeGain(state.envelope, -18.0 + modulation * 2.0, std::clamp(16.0 + modulation * 4.0, 12.0, 20.0));
+		attack = std::clamp(attack * (1.0 + modulation * 0.3), 0.005, 2.0);
+		release = std::clamp(release * (1.0 - modulation * 0.2), 15.0, 1000.0);
+	}
+	else
+	{
+		const double ratio = settings.ratio;
+		const double thresholdDb = ratio == 8.0 ? -10.8 : ratio == 12.0 ? -9.6 : ratio == 20.0 ? -7.6 : -15.0;
+		target = computeGain(state.envelope, thresholdDb, ratio);
+	}
+
+	state.history = 1.0 - target > 0.05
+		? std::min(state.history + 2.0 / overSampledRate, 1.0)
+		: state.history * 0.999;
+	const double coeff = coefficient(target < gain ? attack : release * (1.0 - state.history * 0.6));
+	state.gainReduction = coeff * target + (1.0 - coeff) * gain;
+
+	x *= outputGain;
+	return softClip(std::isfinite(x) ? x : 0.0);
+}
+
+void ReferenceCompressor::process(juce::AudioBuffer<double>& buffer)
+{
+	juce::dsp::AudioBlock<double> block(buffer);
+	auto upsampled = overSampling->processSamplesUp(block);
+
+	for (size_t ch = 0; ch < upsampled.getNumChannels(); ++ch)
+	{
+		auto& state = channels[ch];
+		state.blockMinGain = state.gainReduction;
+		double* samples = upsampled.getChannelPointer(ch);
+		for (size_t i = 0; i < upsampled.getNumSamples(); ++i)
+			samples[i] = processSample(state, samples[i]);
+	}
+
+	overSampling->processSamplesDown(block);
+}
@@ -0,0 +1,149 @@
+#include "BandSplitter.hpp"
+
+template <typename SampleType>
+void BandSplitter<SampleType>::setOversampling(int newStages, bool newLinearPhase)
+{
+	overSamplingStages = juce::jlimit(0, 3, newStages);
+	linearPhaseOverSampling = newLinearPhase;
+}
+
+template <typename SampleType>
+void BandSplitter<SampleType>::setNumBands(int newNumBands) { numBands = juce::jlimit(2, maxBands, newNumBands); }
+
+template <typename SampleType>
+void BandSplitter<SampleType>::prepare(const juce::dsp::ProcessSpec& spec)
+{
+	if (spec.sampleRate <= 0 || spec.numChannels == 0 || spec.maximumBlockSize == 0)
+	{
+		jassertfalse;
+		return;
+	}
+
+	// Same filters as Compressor1176 would use, so the latency is the same
+	// in either mode
+	overSampling = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+		static_cast<size_t>(spec.numChannels),
+		static_cast<size_t>(overSamplingStages),
+		linearPhaseOverSampling ? juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple
+			: juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+		true,
+		true);
+	overSampling->initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+	latencySamples = juce::roundToInt(overSampling->getLatencyInSamples());
+
+	const auto factor = static_cast<juce::uint32>(overSampling->getOversamplingFactor());
+	bandSpec.sampleRate = spec.sampleRate * factor;
+	bandSpec.maximumBlockSize = spec.maximumBlockSize * factor;
+	bandSpec.numChannels = spec.numChannels;
+
+	for (auto& crossover : crossovers)
+		crossover.prepare(bandSpec);
+	for (auto& row : allpasses)
+		for (auto& allpass : row)
+		{
+			allpass.setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+			allpass.prepare(bandSpec);
+		}
+	for (auto& band : bands)
+		band.setSize(static_cast<int>(bandSpec.numChannels), static_cast<int>(bandSpec.maximumBlockSize));
+
+	frequencies.fill(0.0f);
+	updateFrequencies();
+	reset();
+}
+
+template <typename SampleType>
+void BandSplitter<SampleType>::reset()
+{
+	if (overSampling != nullptr)
+		overSampling->reset();
+	for (auto& crossover : crossovers)
+		crossover.reset();
+	for (auto& row : allpasses)
+		for (auto& allpass : row)
+			allpass.reset();
+}
+
+template <typename SampleType>
+void BandSplitter<SampleType>::setCrossoverFrequency(int index, float frequency)
+{
+	jassert(index >= 0 && index < maxBands - 1);
+	if (requestedFrequencies[static_cast<size_t>(index)] == frequency)
+		return;
+	requestedFrequencies[static_cast<size_t>(index)] = frequency;
+	updateFrequencies();
+}
+
+// Kept in order and below the oversampled Nyquist
+template <typename SampleType>
+void BandSplitter<SampleType>::updateFrequencies()
+{
+	if (bandSpec.sampleRate <= 0)
+		return;
+	const float maxFrequency = static_cast<float>(bandSpec.sampleRate * 0.45);
+	float floor = 10.0f;
+	for (size_t k = 0; k < frequencies.size(); ++k)
+	{
+		const float frequency = juce::jlimit(floor, maxFrequency, requestedFrequencies[k]);
+		floor = frequency;
+		if (frequency == frequencies[k])
+			continue;
+		frequencies[k] = frequency;
+		crossovers[k].setCutoffFrequency(static_cast<SampleType>(frequency));
+		if (k > 0)
+			for (auto& allpass : allpasses[k - 1])
+				allpass.setCutoffFrequency(static_cast<SampleType>(frequency));
+	}
+}
+
+// Crossover k splits what is left above the previous one into band k and
+// the rest, then the bands already split off pick up its allpass.
+template <typename SampleType>
+void BandSplitter<SampleType>::split(const juce::dsp::AudioBlock<SampleType>& input)
+{
+	const int numChannels = static_cast<int>(input.getNumChannels());
+	const int numSamples = static_cast<int>(input.getNumSamples());
+	auto& rest = bands[static_cast<size_t>(numBands - 1)];
+	for (int ch = 0; ch < numChannels; ++ch)
+		rest.copyFrom(ch, 0, input.getChannelPointer(static_cast<size_t>(ch)), numSamples);
+
+	for (int k = 0; k < numBands - 1; ++k)
+	{
+		auto& crossover = crossovers[static_cast<size_t>(k)];
+		auto& low = bands[static_cast<size_t>(k)];
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			SampleType* lowSamples = low.getWritePointer(ch);
+			SampleType* highSamples = rest.getWritePointer(ch);
+			for (int i = 0; i < numSamples; ++i)
+				crossover.processSample(ch, highSamples[i], lowSamples[i], highSamples[i]);
+		}
+
+		for (int band = 0; band < k; ++band)
+		{
+			auto& allpass = allpasses[static_cast<size_t>(k - 1)][static_cast<size_t>(band)];
+			for (int ch = 0; ch < numChannels; ++ch)
+			{
+				SampleType* samples = bands[static_cast<size_t>(band)].getWritePointer(ch);
+				for (int i = 0; i < numSamples; ++i)
+					samples[i] = allpass.processSample(ch, samples[i]);
+			}
+		}
+	}
+}
+
+template <typename SampleType>
+void BandSplitter<SampleType>::sum(const juce::dsp::AudioBlock<SampleType>& output) const
+{
+	const int numSamples = static_cast<int>(output.getNumSamples());
+	for (size_t ch = 0; ch < output.getNumChannels(); ++ch)
+	{
+		SampleType* samples = output.getChannelPointer(ch);
+		juce::FloatVectorOperations::copy(samples, bands[0].getReadPointer(static_cast<int>(ch)), numSamples);
+		for (int band = 1; band < numBands; ++band)
+			juce::FloatVectorOperations::add(samples, bands[static_cast<size_t>(band)].getReadPointer(static_cast<int>(ch)), numSamples);
+	}
+}
+
+template class BandSplitter<float>;
+template class BandSplitter<double>;
@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Multiband front end with one oversampling pass for every band. The block
+// is upsampled once, split at the oversampled rate by a tree of 4th-order
+// Linkwitz-Riley crossovers, handed to the caller band by band, summed and
+// downsampled once. Each band below a crossover also runs through that
+// crossover's allpass, so the bands always sum to an allpass: flat
+// magnitude, whatever the crossover settings. All storage is allocated in
+// prepare(). Instantiated for float and double in BandSplitter.cpp.
+template <typename SampleType>
+class BandSplitter
+{
+	public:
+		static constexpr int maxBands = 4;
+
+		// Take effect at the next prepare(); stages 0..3 = 1x..8x
+		void setOversampling(int newStages, bool newLinearPhase);
+		void setNumBands(int newNumBands);
+
+		void prepare(const juce::dsp::ProcessSpec& spec);
+		void reset();
+
+		// Crossover index 0..maxBands-2, from the bottom. Each one is kept at
+		// or above the one below it; unchanged values cost nothing.
+		void setCrossoverFrequency(int index, float frequency);
+
+		int getNumBands() const { return numBands; }
+		int getLatencySamples() const { return latencySamples; }
+		// What the band processors are prepared with: oversampled rate and block size
+		const juce::dsp::ProcessSpec& getBandSpec() const { return bandSpec; }
+
+		// processBand(int band, juce::AudioBuffer<SampleType>& bandBuffer) may
+		// change the band in place; buffer is replaced by the downsampled sum
+		template <typename BandFunction>
+		void process(juce::AudioBuffer<SampleType>& buffer, BandFunction&& processBand)
+		{
+			juce::dsp::AudioBlock<SampleType> block(buffer);
+			const juce::dsp::AudioBlock<SampleType> oversampled = overSampling->processSamplesUp(block);
+			split(oversampled);
+
+			const int numChannels = static_cast<int>(oversampled.getNumChannels());
+			const int numSamples = static_cast<int>(oversampled.getNumSamples());
+			for (int band = 0; band < numBands; ++band)
+			{
+				// Refers to the band's storage, sized to this block
+				juce::AudioBuffer<SampleType> bandBuffer(bands[static_cast<size_t>(band)].getArrayOfWritePointers(), numChannels, numSamples);
+				processBand(band, bandBuffer);
+			}
+			sum(oversampled);
+			overSampling->processSamplesDown(block);
+		}
+
+	private:
+		using Crossover = juce::dsp::LinkwitzRileyFilter<SampleType>;
+
+		void split(const juce::dsp::AudioBlock<SampleType>& input);
+		void sum(const juce::dsp::AudioBlock<SampleType>& output) const;
+		void updateFrequencies();
+
+		int overSamplingStages = 2;
+		bool linearPhaseOverSampling = false;
+		int numBands = 2;
+		int latencySamples = 0;
+		juce::dsp::ProcessSpec bandSpec { 0.0, 0, 0 };
+		std::unique_ptr<juce::dsp::Oversampling<SampleType>> overSampling;
+
+		std::array<float, maxBands - 1> requestedFrequencies { 120.0f, 1000.0f, 5000.0f };
+		std::array<float, maxBands - 1> frequencies {};
+		std::array<Crossover, maxBands - 1> crossovers;
+		// allpasses[k - 1][band]: crossover k's phase, for each band below it
+		std::array<std::array<Crossover, maxBands - 2>, maxBands - 2> allpasses;
+		std::array<juce::AudioBuffer<SampleType>, maxBands> bands;
+};
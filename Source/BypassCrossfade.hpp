@@ -0,0 +1,56 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Equal-power crossfade between the wet path and the latency-aligned dry
+// path. The cos curve is tabulated in prepare(); position walks one entry
+// per sample towards 0 (wet) or fadeLength (bypassed), and the dry gain
+// reads the same table from the other end (sin x = cos(pi/2 - x)).
+class BypassCrossfade
+{
+	public:
+		void prepare(double sampleRate, double fadeSeconds = 0.02)
+		{
+			fadeLength = std::max(1, juce::roundToInt(sampleRate * fadeSeconds));
+			curve.resize(static_cast<size_t>(fadeLength) + 1);
+			for (int i = 0; i <= fadeLength; ++i)
+				curve[static_cast<size_t>(i)] = static_cast<float>(std::cos(juce::MathConstants<double>::halfPi * i / fadeLength));
+			position = target = bypassed ? fadeLength : 0;
+		}
+
+		void setBypassed(bool shouldBeBypassed)
+		{
+			bypassed = shouldBeBypassed;
+			target = bypassed ? fadeLength : 0;
+		}
+
+		bool isFullyBypassed() const { return position == fadeLength && target == fadeLength; }
+		bool isFading() const { return position != target; }
+
+		// wet = wet * cos + dry * sin over the first numSamples
+		template <typename SampleType>
+		void process(juce::AudioBuffer<SampleType>& wet, const juce::AudioBuffer<SampleType>& dry, int numSamples) noexcept
+		{
+			const int step = target > position ? 1 : -1;
+			int end = position;
+			for (int ch = 0; ch < wet.getNumChannels(); ++ch)
+			{
+				SampleType* out = wet.getWritePointer(ch);
+				const SampleType* in = dry.getReadPointer(ch);
+				int pos = position;
+				for (int i = 0; i < numSamples; ++i)
+				{
+					pos = pos == target ? pos : pos + step;
+					out[i] = out[i] * curve[static_cast<size_t>(pos)] + in[i] * curve[static_cast<size_t>(fadeLength - pos)];
+				}
+				end = pos;
+			}
+			position = end;
+		}
+
+	private:
+		std::vector<float> curve;
+		int fadeLength = 1;
+		int position = 0;
+		int target = 0;
+		bool bypassed = false;
+};
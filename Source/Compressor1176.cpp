@@ -1,6 +1,7 @@
 #include "Compressor1176.hpp"
 
-Compressor1176::Compressor1176() {}
+template <typename SampleType>
+BasicCompressor1176<SampleType>::BasicCompressor1176() {}
 
 static float clamp(float value)
 {
@@ -12,30 +13,161 @@ static float clamp(float value)
 		return value;
 }
 
-float Compressor1176::mapAttackMs(float knobValue)
+template <typename SampleType>
+float BasicCompressor1176<SampleType>::mapAttackMs(float knobValue) const
 {
 	return juce::jmap(clamp(knobValue), 1.0f, 7.0f, 0.8f, 0.02f);
 }
 
-float Compressor1176::mapReleaseMs(float knobValue)
+template <typename SampleType>
+float BasicCompressor1176<SampleType>::mapReleaseMs(float knobValue) const
 {
 	return juce::jmap(clamp(knobValue), 1.0f, 7.0f, 1100.0f, 50.0f);
 }
-void Compressor1176::setInputGain(float newInputGain) { inputGain = newInputGain; }
-void Compressor1176::setRatio(float newRatio) { ratio = newRatio; }
-void Compressor1176::setAllButtons(bool newValue) { allButtonsMode = newValue; }
+// The input gain is compensated w/ +12.0f (and later in output gain -12.0f)
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setInputGain(float newInputGain)
+{
+	if (newInputGain == inputGain)
+		return;
+	inputGain = newInputGain;
+	inputGainSmoothed.setTargetValue(juce::Decibels::decibelsToGain(static_cast<SampleType>(inputGain) + 12));
+}
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setRatio(float newRatio)
+{
+	ratio = newRatio;
+	gainComputer.setRatio(ratio);
+}
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setAllButtons(bool newValue) { allButtonsMode = newValue; }
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setOversampling(int newStages, bool newLinearPhase)
+{
+	overSamplingStages = juce::jlimit(0, 3, newStages);
+	linearPhaseOverSampling = newLinearPhase;
+}
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setSplitRateDetector(bool newValue) { splitRateRequested = newValue; }
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setLookahead(float newLookaheadMs) { lookaheadMs = juce::jlimit(0.0f, maxLookaheadMs, newLookaheadMs); }
 
-void Compressor1176::setAttack(float knobValue)
+// Linking hands each group's slot the sidechain of its most compressed
+// channel, unlinking gives every channel a copy of its group's, so the GR
+// carries on from where it was either way. A slot is never above any of
+// its channels, so walking up the slots and down the channels reads every
+// sidechain before it is overwritten.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setLinkMode(LinkMode newMode)
 {
-	attackTime = mapAttackMs(knobValue);
+	const bool wasLinked = isLinked(numChannels);
+	linkMode = newMode;
+	if (wasLinked == isLinked(numChannels) || smoothedGainReduction.empty())
+		return;
+
+	if (!wasLinked)
+	{
+		for (int slot = 0; slot < numLinkSlots; ++slot)
+		{
+			int from = linkSlotMembers[static_cast<size_t>(linkSlotStart[static_cast<size_t>(slot)])];
+			for (int k = linkSlotStart[static_cast<size_t>(slot)] + 1; k < linkSlotStart[static_cast<size_t>(slot) + 1]; ++k)
+			{
+				const int ch = linkSlotMembers[static_cast<size_t>(k)];
+				if (smoothedGainReduction[static_cast<size_t>(ch)] < smoothedGainReduction[static_cast<size_t>(from)])
+					from = ch;
+			}
+			copySidechain(from, slot);
+		}
+	}
+	else
+		for (int ch = numChannels - 1; ch >= 0; --ch)
+			copySidechain(linkSlot[static_cast<size_t>(ch)], ch);
 }
-void Compressor1176::setRelease(float knobValue)
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::copySidechain(int from, int to)
+{
+	if (from == to)
+		return;
+	const auto f = static_cast<size_t>(from);
+	const auto t = static_cast<size_t>(to);
+	envelope[t] = envelope[f];
+	smoothedGainReduction[t] = smoothedGainReduction[f];
+	compressionHistory[t] = compressionHistory[f];
+	transientDetector[t] = transientDetector[f];
+	slowEnvelope[t] = slowEnvelope[f];
+	ratioModulation[t] = ratioModulation[f];
+	std::copy(sidechainGain.getReadPointer(from), sidechainGain.getReadPointer(from, sidechainDelay), sidechainGain.getWritePointer(to));
+}
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setLinkGroups(std::vector<int> newGroups) { linkGroups = std::move(newGroups); }
+
+// Numbers the link groups' slots for the prepared layout and lists each
+// slot's channels, in ascending order
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::prepareLinkSlots()
+{
+	auto groupOf = [this](int ch) {
+		if (linkGroups.empty())
+			return 1;
+		return ch < static_cast<int>(linkGroups.size()) ? linkGroups[static_cast<size_t>(ch)] : 0;
+	};
+	linkSlot.assign(static_cast<size_t>(numChannels), 0);
+	numLinkSlots = 0;
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		int slot = numLinkSlots;
+		if (groupOf(ch) > 0)
+			for (int other = 0; other < ch; ++other)
+				if (groupOf(other) == groupOf(ch))
+				{
+					slot = linkSlot[static_cast<size_t>(other)];
+					break;
+				}
+		linkSlot[static_cast<size_t>(ch)] = slot;
+		numLinkSlots = std::max(numLinkSlots, slot + 1);
+	}
+
+	linkSlotStart.assign(static_cast<size_t>(numLinkSlots) + 1, 0);
+	for (int slot : linkSlot)
+		++linkSlotStart[static_cast<size_t>(slot) + 1];
+	for (size_t slot = 0; slot < static_cast<size_t>(numLinkSlots); ++slot)
+		linkSlotStart[slot + 1] += linkSlotStart[slot];
+	std::vector<int> next(linkSlotStart.begin(), linkSlotStart.end() - 1);
+	linkSlotMembers.resize(static_cast<size_t>(numChannels));
+	for (int ch = 0; ch < numChannels; ++ch)
+		linkSlotMembers[static_cast<size_t>(next[static_cast<size_t>(linkSlot[static_cast<size_t>(ch)])]++)] = ch;
+}
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setAttack(float knobValue)
+{
+	float newAttackTime = mapAttackMs(knobValue);
+	if (newAttackTime == attackTime)
+		return;
+	attackTime = newAttackTime;
+	attackCoeff = getSmoothingCoeff(attackTime);
+}
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setRelease(float knobValue)
 {
 	releaseTime = mapReleaseMs(knobValue);
 }
-void Compressor1176::setOutputGain(float newOutputGain) { outputGain = newOutputGain; }
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::setOutputGain(float newOutputGain)
+{
+	if (newOutputGain == outputGain)
+		return;
+	outputGain = newOutputGain;
+	outputGainSmoothed.setTargetValue(juce::Decibels::decibelsToGain(static_cast<SampleType>(outputGain) - 12));
+}
 
-void Compressor1176::prepare( const juce::dsp::ProcessSpec& spec)
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::prepare( const juce::dsp::ProcessSpec& spec)
 {
 	if (spec.sampleRate <= 0 || spec.numChannels == 0 || spec.maximumBlockSize == 0)
 	{
@@ -44,104 +176,167 @@ void Compressor1176::prepare( const juce::dsp::ProcessSpec& spec)
 	}
 	sampleRate = spec.sampleRate;
 	numChannels = static_cast<int>(spec.numChannels);
+
+	// Integer latency so the host (and any dry path) can compensate exactly
+	overSampling = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+		static_cast<size_t>(numChannels),
+		static_cast<size_t>(overSamplingStages),
+		linearPhaseOverSampling ? juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple
+			: juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+		true,
+		true);
+	overSampling->initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+	overSamplingFactor = static_cast<float>(overSampling->getOversamplingFactor());
 	overSampledRate = sampleRate * overSamplingFactor;
+	lookaheadSamples = juce::roundToInt(lookaheadMs * 0.001 * sampleRate);
+	latencySamples = juce::roundToInt(overSampling->getLatencyInSamples()) + lookaheadSamples;
 
-	envelope.clear();
-	envelope.resize(numChannels, 0.0f);
-	smoothedGainReduction.clear();
-	smoothedGainReduction.resize(numChannels, 1.0f);
-	overSampling.initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+	// Split rate only means something when there is oversampling to skip.
+	// Half the round trip is the upsampling filter, which the interpolated
+	// GR is delayed by (at least one sample, the interpolation needs it).
+	splitRateDetector = splitRateRequested && overSamplingStages > 0;
+	detectorRate = splitRateDetector ? sampleRate : overSampledRate;
+	sidechainDelay = splitRateDetector ? std::max(1, juce::roundToInt(overSampling->getLatencyInSamples() * 0.5)) : 0;
 
 	juce::dsp::ProcessSpec overSampledSpec;
 	overSampledSpec.sampleRate = overSampledRate;
 	overSampledSpec.maximumBlockSize = spec.maximumBlockSize * static_cast<int>(overSamplingFactor);
 	overSampledSpec.numChannels = spec.numChannels;
 
-	transientDetector.resize(numChannels, 0.0f);
-	slowEnvelope.resize(numChannels, 0.0f);
-
-	lowShelfFilter.clear();
-	highShelfFilter.clear();
-	lowShelfFilter.resize(numChannels);
-	highShelfFilter.resize(numChannels);
-	lastBoostDb.resize(numChannels, 0.0f);
-	compressionHistory.resize(numChannels, 0.0f);
-	for (int ch = 0; ch < numChannels; ++ch)
+	inputGainSmoothed.reset(overSampledRate, gainRampSeconds);
+	outputGainSmoothed.reset(overSampledRate, gainRampSeconds);
+	inputGainSmoothed.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(static_cast<SampleType>(inputGain) + 12));
+	outputGainSmoothed.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(static_cast<SampleType>(outputGain) - 12));
+	inputGainRamp.resize(overSampledSpec.maximumBlockSize);
+	outputGainRamp.resize(overSampledSpec.maximumBlockSize);
+
+	prepareLinkSlots();
+	envelope.resize(numChannels);
+	lookaheadDelay.prepare(numChannels, lookaheadSamples * static_cast<int>(overSamplingFactor));
+	peakWindows.resize(numChannels);
+	for (auto& window : peakWindows)
+		window.prepare(1 + lookaheadSamples * (splitRateDetector ? 1 : static_cast<int>(overSamplingFactor)));
+	smoothedGainReduction.resize(numChannels);
+	transientDetector.resize(numChannels);
+	slowEnvelope.resize(numChannels);
+	ratioModulation.resize(numChannels);
+	compressionHistory.resize(numChannels);
+	blockMinGain.resize(numChannels);
+	for (int k = 0; k < 2; ++k)
 	{
-		lowShelfFilter[ch].prepare(overSampledSpec);
-		highShelfFilter[ch].prepare(overSampledSpec);
-		lowShelfFilter[ch].reset();
-		highShelfFilter[ch].reset();
-	};
-	initFETLookup();
+		lowShelfState[k].resize(numChannels);
+		highShelfState[k].resize(numChannels);
+	}
+	gainBuffer.setSize(numChannels, static_cast<int>(overSampledSpec.maximumBlockSize));
+	heldInput.setSize(numChannels, static_cast<int>(overSampledSpec.maximumBlockSize));
+	sidechainGain.setSize(numChannels, sidechainDelay + static_cast<int>(spec.maximumBlockSize));
+	zeroChannel.assign(overSampledSpec.maximumBlockSize, 0.0f);
+	linkBuffer.setSize(numLinkSlots, static_cast<int>(overSampledSpec.maximumBlockSize));
+	linkInputs.assign(static_cast<size_t>(numLinkSlots), nullptr);
+	linkChannels.assign(static_cast<size_t>(numChannels), nullptr);
+
+	updateSmoothingCoeffs();
+	gainComputer.prepare();
+	shelfBank.prepare(overSampledRate);
+	reset();
 }
 
-void Compressor1176::reset()
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::reset()
 {
-	overSampling.reset();
-	envelope.resize(numChannels, 0.0f);
-	smoothedGainReduction.resize(numChannels, 1.0f);
-	transientDetector.resize(numChannels, 0.0f);
-	slowEnvelope.resize(numChannels, 0.0f);
-	ratioModulation = 0.0f;
-	lowShelfFilter.clear();
-	highShelfFilter.clear();
-	for (int ch = 0; ch < numChannels; ++ch)
+	if (overSampling != nullptr)
+		overSampling->reset();
+	lookaheadDelay.reset();
+	for (auto& window : peakWindows)
+		window.reset();
+	std::fill(envelope.begin(), envelope.end(), 0.0f);
+	std::fill(smoothedGainReduction.begin(), smoothedGainReduction.end(), 1.0f);
+	std::fill(transientDetector.begin(), transientDetector.end(), 0.0f);
+	std::fill(slowEnvelope.begin(), slowEnvelope.end(), 0.0f);
+	std::fill(ratioModulation.begin(), ratioModulation.end(), 0.0f);
+	std::fill(compressionHistory.begin(), compressionHistory.end(), 0.0f);
+	for (int k = 0; k < 2; ++k)
 	{
-		lowShelfFilter[ch].reset();
-		highShelfFilter[ch].reset();
+		std::fill(lowShelfState[k].begin(), lowShelfState[k].end(), 0.0f);
+		std::fill(highShelfState[k].begin(), highShelfState[k].end(), 0.0f);
 	}
-	lastBoostDb.resize(numChannels, 0.0f);
-	lastGainReductionDb = 0.f;
-	compressionHistory.resize(numChannels, 0.0f);
+	for (int ch = 0; ch < sidechainGain.getNumChannels(); ++ch)
+		std::fill(sidechainGain.getWritePointer(ch), sidechainGain.getWritePointer(ch, sidechainDelay), 1.0f);
+	std::fill(blockMinGain.begin(), blockMinGain.end(), 1.0f);
+	idle = false;
+	silentSamples = 0;
+	shaperStale = false;
+	inputGainSmoothed.setCurrentAndTargetValue(inputGainSmoothed.getTargetValue());
+	outputGainSmoothed.setCurrentAndTargetValue(outputGainSmoothed.getTargetValue());
 }
 
-float Compressor1176::getThreshold()
+// Silent input leaves GR recovering at the slowest release; the tail runs
+// until it is back within idleGainReduction of unity from the 60 dB floor,
+// plus the oversampler's latency.
+template <typename SampleType>
+double BasicCompressor1176<SampleType>::getTailLengthSeconds() const
 {
-	if (allButtonsMode)
-	{
-		float baseThreshold = -18.f;
-		float modulation = ratioModulation * 2.0f;
-		return baseThreshold + modulation;
-	}
-	if (ratio == 4.0f)	return -15.f;
-	if (ratio == 8.0f)	return -10.8f;
-	if (ratio == 12.0f)	return -9.6f;
-	if (ratio == 20.0f)	return -7.6f;
-
-	return (-15.f);
+	const double releaseSeconds = 0.001 * mapReleaseMs(1.0f);
+	const double timeConstants = std::log((1.0 - 0.001) / (1.0 - idleGainReduction));
+	return releaseSeconds * timeConstants + latencySamples / sampleRate;
 }
 
-float Compressor1176::getRatio()
+template <typename SampleType>
+bool BasicCompressor1176<SampleType>::isSettled() const
 {
-	if (allButtonsMode)
+	// Linked, only the groups' slots have a sidechain running
+	const int sidechainChannels = isLinked(numChannels) ? numLinkSlots : numChannels;
+	for (int ch = 0; ch < numChannels; ++ch)
 	{
-		float baseRatio = 16.0f;
-		float variation = ratioModulation * 4.0f;
-		return std::clamp(baseRatio + variation, 12.0f, 20.0f);
+		if (ch < sidechainChannels
+			&& (smoothedGainReduction[ch] < idleGainReduction
+				|| envelope[ch] > silenceThreshold
+				|| transientDetector[ch] > silenceThreshold
+				|| slowEnvelope[ch] > silenceThreshold))
+			return false;
+		if (std::abs(lowShelfState[0][ch]) > silenceThreshold || std::abs(lowShelfState[1][ch]) > silenceThreshold
+			|| std::abs(highShelfState[0][ch]) > silenceThreshold || std::abs(highShelfState[1][ch]) > silenceThreshold)
+			return false;
 	}
-	return ratio;
+	return true;
 }
 
-float Compressor1176::computeGainReduction(float level)
+// Everything else is already below the silence threshold; GR, its history
+// and the modulation jump to where they would have decayed to, which is
+// inaudible under a signal that is just starting from silence.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::wakeFromIdle()
 {
-	float threshold = getThreshold();
-	float inputLevelDb = juce::Decibels::gainToDecibels(level + 1e-12f);
-	if (inputLevelDb <= threshold)
-		return 1.0f;
+	idle = false;
+	std::fill(smoothedGainReduction.begin(), smoothedGainReduction.end(), 1.0f);
+	std::fill(compressionHistory.begin(), compressionHistory.end(), 0.0f);
+	std::fill(ratioModulation.begin(), ratioModulation.end(), 0.0f);
+	for (int ch = 0; ch < sidechainGain.getNumChannels(); ++ch)
+		std::fill(sidechainGain.getWritePointer(ch), sidechainGain.getWritePointer(ch, sidechainDelay), 1.0f);
+}
 
-	float effectiveRatio = getRatio();
-	float outputLevelDb = threshold + (inputLevelDb - threshold) / effectiveRatio;
-	float gainReductionDb = inputLevelDb - outputLevelDb;
-	gainReductionDb = std::clamp(gainReductionDb, 0.0f, 60.0f);
-	return juce::Decibels::decibelsToGain(-gainReductionDb);
+// Evaluated in double with expm1: in float, 1 - exp(-x) loses ~1% for the
+// long release times at high oversampled rates.
+template <typename SampleType>
+SampleType BasicCompressor1176<SampleType>::getSmoothingCoeff(float timeMs)
+{
+	if (detectorRate <= 0 || timeMs <= 0)
+		return 0;
+	return static_cast<SampleType>(-std::expm1(-1.0 / (0.001 * timeMs * detectorRate)));
 }
 
-float Compressor1176::getSmoothingCoeff(float timeMs)
+// The table spans the All-Buttons attack floor (0.005 ms) up past the
+// slowest release; 64 segments per octave keep it within 1e-4 (relative)
+// of the exact coefficient.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::updateSmoothingCoeffs()
 {
-	if (sampleRate <= 0 || timeMs <= 0)
-		return 0.0f;
-	return 1.0f - std::exp(-1.0f / (0.001f * timeMs * overSampledRate));
+	smoothingCoeffTable.build(0.005f, 2000.0f, [this](float timeMs) { return static_cast<float>(getSmoothingCoeff(timeMs)); });
+	detectorAttackCoeff = getSmoothingCoeff(0.02f);
+	detectorReleaseCoeff = getSmoothingCoeff(1.5f);
+	transientFastCoeff = getSmoothingCoeff(0.5f);
+	transientSlowCoeff = getSmoothingCoeff(50.0f);
+	attackCoeff = getSmoothingCoeff(attackTime);
 }
 
 // Changing the beta to smaller values makes the detection slower
@@ -158,179 +353,459 @@ float Compressor1176::getSmoothingCoeff(float timeMs)
 // 	return envelope[ch];
 // }
 
-float Compressor1176::processPeak(int ch, float sample)
-{
-	if (ch < 0 || ch >= static_cast<int>(envelope.size()))
-		return 0.0f;
-
-	float absSample = std::abs(sample);
-	float attackCoeff = getSmoothingCoeff(0.02f);
-	float releaseCoeff = getSmoothingCoeff(1.5f);
-	if (absSample > envelope[ch])
-		envelope[ch] = attackCoeff * absSample + (1.0f - attackCoeff) * envelope[ch];
-	else
-		envelope[ch] = releaseCoeff * absSample + (1.0f - releaseCoeff) * envelope[ch];
-	return envelope[ch];
-}
-
-float Compressor1176::softClip(float x)
+// Writes the block's gain curve into ramp; returns false (ramp untouched)
+// when the gain is steady and the caller can use the target directly.
+template <typename SampleType>
+bool BasicCompressor1176<SampleType>::fillGainRamp(SmoothedGain& gain, std::vector<SampleType>& ramp, size_t numSamples)
 {
-	const float threshold = 0.98f;
-	if (x > threshold)
-		return threshold + std::tanh(x - threshold) * 0.05f;
-	else if (x < -threshold)
-		return -threshold + std::tanh(x + threshold) * 0.05f;
-	else
-		return x;
+	if (!gain.isSmoothing())
+		return false;
+	jassert(numSamples <= ramp.size());
+	for (size_t i = 0; i < numSamples; ++i)
+		ramp[i] = gain.getNextValue();
+	return true;
 }
 
-// The input gain is compensated w/ +12.0f (and later in output gain -12.0f)
-void Compressor1176::process(juce::AudioBuffer<float>& buffer)
+// One channel at a time, sample inner, with the channel's state held in
+// locals for the block. The modes are template parameters, picked once per
+// block by detectChannel() and shapeChannel(), so each instantiation's
+// sample loop has no mode tests left in it.
+//
+// The ratio needs no instantiation of its own: GainComputer reads the same
+// kind of table for every button. Coefficients are copied to locals up
+// front; as members they could alias the output and would be reloaded
+// every sample.
+//
+// detectKernel() is the sidechain: detector, gain computer and GR
+// ballistics. It writes the gain each sample is multiplied by to gainOut,
+// which shapeKernel() then applies ahead of the FET, shelf and soft clip
+// stages.
+template <typename SampleType>
+template <bool AllButtons, bool Lookahead>
+void BasicCompressor1176<SampleType>::detectKernel(const SampleType* in, int channel, size_t numSamples,
+	const SampleType* inputRamp, size_t rampStride, SampleType* gainOut)
 {
-	juce::dsp::AudioBlock<float> inputBlock(buffer);
-	juce::dsp::AudioBlock<float> oversampledBlock = overSampling.processSamplesUp(inputBlock);
-	float maxGrDb = 0.f;
-	for (int ch = 0; ch < oversampledBlock.getNumChannels(); ++ch)
+	const size_t ch = static_cast<size_t>(channel);
+	SampleType env = envelope[ch];
+	SampleType gr = smoothedGainReduction[ch];
+	SampleType history = compressionHistory[ch];
+	SampleType fast = transientDetector[ch];
+	SampleType slow = slowEnvelope[ch];
+	SampleType modulation = ratioModulation[ch];
+	auto& peakWindow = peakWindows[ch];
+
+	const SampleType steadyInputGain = inputGainSmoothed.getTargetValue();
+	const SampleType buildUpRate = SampleType(2) / static_cast<SampleType>(detectorRate);
+	const SampleType envAttackCoeff = detectorAttackCoeff;
+	const SampleType envReleaseCoeff = detectorReleaseCoeff;
+	const SampleType fastCoeff = transientFastCoeff;
+	const SampleType slowCoeff = transientSlowCoeff;
+	const SampleType fixedAttackCoeff = attackCoeff;
+	const float attackMs = attackTime;
+	const float releaseMs = releaseTime;
+	SampleType minGain = gr;
+
+	for (size_t i = 0; i < numSamples; ++i)
 	{
-		float* data = oversampledBlock.getChannelPointer(ch);
-		size_t numSamples = oversampledBlock.getNumSamples();
+		const SampleType inGain = inputRamp != nullptr ? inputRamp[i * rampStride] : steadyInputGain;
+		SampleType x = in[i] * inGain;
 
-		for (size_t i = 0; i < numSamples; ++i)
+		if constexpr (AllButtons)
 		{
-			float sample = data[i] * juce::Decibels::decibelsToGain(inputGain + 12.0f);
+			SampleType absSample = std::abs(x);
+			fast = fastCoeff * absSample + (1.0f - fastCoeff) * fast;
+			slow = slowCoeff * absSample + (1.0f - slowCoeff) * slow;
+			SampleType transientRatio = fast / (slow + 1e-6f);
+			modulation = transientRatio > 1.3f
+				? std::clamp((transientRatio - SampleType(1.5)) * SampleType(0.3), SampleType(-0.5), SampleType(0.5))
+				: modulation * 0.995f;
+			x = FETShaper::lookup(x * 1.15f);
+		}
 
-			if (allButtonsMode)
-			{
-				float absSample = std::abs(sample);
-				float fastCoeff = getSmoothingCoeff(0.5f);
-				float slowCoeff = getSmoothingCoeff(50.0f);
-				transientDetector[ch] = fastCoeff * absSample + (1.0f - fastCoeff) * transientDetector[ch];
-				slowEnvelope[ch] = slowCoeff * absSample + (1.0f - slowCoeff) * slowEnvelope[ch];
-				float transientRatio = transientDetector[ch] / (slowEnvelope[ch] + 1e-6f);
-				bool isTransient = transientRatio > 1.3f;
-				if (isTransient)
-				{
-					ratioModulation = std::clamp((transientRatio - 1.5f) * 0.3f, -0.5f, 0.5f);
-				}
-				else
-				{
-					ratioModulation *= 0.995f;
-				}
-				sample = lookupFET(sample * 1.15f);
-			}
-			sample *= smoothedGainReduction[ch];
-			float peakLevel = processPeak(ch, sample);
-			sample = lookupFET(sample);
-			if (smoothedGainReduction[ch] < 0.95f)
-			{
-				float maxBoost = 1.0f;
-				float boostDb = juce::jmap(1.0f - smoothedGainReduction[ch], 0.0f, 1.0f, 0.0f, maxBoost);
-				if (std::abs(boostDb - lastBoostDb[ch]) > 0.1f)
-				{
-					lowShelfFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-						overSampledRate, 100.0f, 0.707f, juce::Decibels::decibelsToGain(boostDb));
-					highShelfFilter[ch].coefficients = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-						overSampledRate, 8000.0f, 0.707f, juce::Decibels::decibelsToGain(boostDb));
-					lastBoostDb[ch] = boostDb;
-				}
-				sample = lowShelfFilter[ch].processSample(sample);
-				sample = highShelfFilter[ch].processSample(sample);
-			}
-			float targetGainReduction = computeGainReduction(peakLevel);
-			float tempGrDb = juce::Decibels::gainToDecibels(targetGainReduction + 1e-12f);
-			maxGrDb = std::min(maxGrDb, tempGrDb);
+		gainOut[i] = gr;
+		minGain = std::min(minGain, gr);
+		SampleType level = std::abs(x * gr);
+		// Amortised O(1) at any window length
+		if constexpr (Lookahead)
+			level = peakWindow.process(level);
 
-			float effectiveAttackTime = attackTime;
-			float effectiveReleaseTime = releaseTime;
-			if (allButtonsMode)
-			{
-				effectiveAttackTime *= (1.0f + ratioModulation * 0.3f);
-				effectiveReleaseTime *= (1.0f - ratioModulation * 0.2f);
-				effectiveAttackTime = std::clamp(effectiveAttackTime, 0.005f, 2.0f);
-				effectiveReleaseTime = std::clamp(effectiveReleaseTime, 15.0f, 1000.0f);
-			}
+		SampleType envCoeff = level > env ? envAttackCoeff : envReleaseCoeff;
+		env = envCoeff * level + (1.0f - envCoeff) * env;
 
-			float compressionAmount = 1.0f - targetGainReduction;
-			if (compressionAmount > 0.05f)
-			{
-				float buildUpdRate = 2.0f / static_cast<float>(overSampledRate);
-				compressionHistory[ch] = std::min(compressionHistory[ch] + buildUpdRate, 1.0f);
-			}
-			else
-				compressionHistory[ch] *= 0.999f;
-			float programDependentRelease = effectiveReleaseTime * (1.0f - compressionHistory[ch] * 0.6f);
-
-			float coeff = (targetGainReduction < smoothedGainReduction[ch])
-				? getSmoothingCoeff(effectiveAttackTime)
-				: getSmoothingCoeff(programDependentRelease);
-			smoothedGainReduction[ch] = coeff * targetGainReduction + (1.0f - coeff) * smoothedGainReduction[ch];
-
-			sample *= juce::Decibels::decibelsToGain(outputGain - 12.0f);
-			if (std::isnan(sample) || std::isinf(sample))
-				sample = 0.0f;
-			sample = softClip(sample);
-			data[i] = sample;
+		SampleType targetGainReduction;
+		SampleType attack;
+		float effectiveReleaseTime = releaseMs;
+		if constexpr (AllButtons)
+		{
+			targetGainReduction = gainComputer.getGain(static_cast<float>(env), static_cast<float>(modulation));
+			const float mod = static_cast<float>(modulation);
+			float effectiveAttackTime = attackMs * (1.0f + mod * 0.3f);
+			effectiveReleaseTime *= (1.0f - mod * 0.2f);
+			effectiveAttackTime = std::clamp(effectiveAttackTime, 0.005f, 2.0f);
+			effectiveReleaseTime = std::clamp(effectiveReleaseTime, 15.0f, 1000.0f);
+			attack = static_cast<SampleType>(smoothingCoeffTable(effectiveAttackTime));
 		}
+		else
+		{
+			targetGainReduction = gainComputer.getGain(static_cast<float>(env));
+			attack = fixedAttackCoeff;
+		}
+
+		SampleType compressionAmount = 1.0f - targetGainReduction;
+		history = compressionAmount > 0.05f
+			? std::min(history + buildUpRate, SampleType(1))
+			: history * 0.999f;
+		float programDependentRelease = effectiveReleaseTime * (1.0f - static_cast<float>(history) * 0.6f);
+
+		SampleType release = smoothingCoeffTable(programDependentRelease);
+		SampleType coeff = targetGainReduction < gr ? attack : release;
+		gr = coeff * targetGainReduction + (1.0f - coeff) * gr;
 	}
-	lastGainReductionDb.store(maxGrDb);
-	overSampling.processSamplesDown(inputBlock);
+
+	envelope[ch] = env;
+	smoothedGainReduction[ch] = gr;
+	compressionHistory[ch] = history;
+	transientDetector[ch] = fast;
+	slowEnvelope[ch] = slow;
+	ratioModulation[ch] = modulation;
+	blockMinGain[ch] = minGain;
 }
 
-// Smaller asym value equals less colouration, bigger more.
-float Compressor1176::saturateFET(float x, float drive)
+template <typename SampleType>
+template <bool AllButtons>
+void BasicCompressor1176<SampleType>::shapeKernel(SampleType* samples, int channel, size_t numSamples,
+	const SampleType* inputRamp, const SampleType* outputRamp, const SampleType* gain)
 {
-	float threshold = 0.7f;
-	float scaledInput = x / threshold;
+	const size_t ch = static_cast<size_t>(channel);
+	double lowZ1 = lowShelfState[0][ch];
+	double lowZ2 = lowShelfState[1][ch];
+	double highZ1 = highShelfState[0][ch];
+	double highZ2 = highShelfState[1][ch];
 
-	float asym = 0.3f;
+	const SampleType steadyInputGain = inputGainSmoothed.getTargetValue();
+	const SampleType steadyOutputGain = outputGainSmoothed.getTargetValue();
 
-	float linearPart = scaledInput;
-	float saturatedPart = 0;
+	for (size_t i = 0; i < numSamples; ++i)
+	{
+		const SampleType inGain = inputRamp != nullptr ? inputRamp[i] : steadyInputGain;
+		const SampleType outGain = outputRamp != nullptr ? outputRamp[i] : steadyOutputGain;
+		const SampleType gr = gain[i];
+		SampleType x = samples[i] * inGain;
+
+		if constexpr (AllButtons)
+			x = FETShaper::lookup(x * 1.15f);
+		x = FETShaper::lookup(x * gr);
+
+		// Coloration shelves only run while compressing past ~0.45 dB of GR
+		if (gr < 0.95f)
+		{
+			double c[ShelfCoefficientBank::numCoeffs];
+			shelfBank.lookup((1.0 - gr) * ShelfCoefficientBank::maxBoostDb, c);
+			const double in = x;
+			double low = c[0] * in + lowZ1;
+			lowZ1 = c[1] * in - c[3] * low + lowZ2;
+			lowZ2 = c[2] * in - c[4] * low;
+			double high = c[5] * low + highZ1;
+			highZ1 = c[6] * low - c[8] * high + highZ2;
+			highZ2 = c[7] * low - c[9] * high;
+			x = static_cast<SampleType>(high);
+		}
 
-	if (scaledInput >= 0.0f)
-		saturatedPart = std::tanh(drive * scaledInput);
+		x *= outGain;
+		x = std::isfinite(x) ? x : SampleType();
+		samples[i] = FETShaper::softClip(x);
+	}
+
+	lowShelfState[0][ch] = lowZ1;
+	lowShelfState[1][ch] = lowZ2;
+	highShelfState[0][ch] = highZ1;
+	highShelfState[1][ch] = highZ2;
+}
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::detectChannel(const SampleType* in, int channel, size_t numSamples,
+	const SampleType* inputRamp, size_t rampStride, SampleType* gainOut)
+{
+	auto run = [&](auto allButtons, auto lookahead) {
+		detectKernel<decltype(allButtons)::value, decltype(lookahead)::value>(in, channel, numSamples,
+			inputRamp, rampStride, gainOut);
+	};
+	if (allButtonsMode)
+	{
+		if (lookaheadSamples > 0)
+			run(std::true_type {}, std::true_type {});
+		else
+			run(std::true_type {}, std::false_type {});
+	}
+	else
+	{
+		if (lookaheadSamples > 0)
+			run(std::false_type {}, std::true_type {});
+		else
+			run(std::false_type {}, std::false_type {});
+	}
+}
+
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::shapeChannel(SampleType* samples, int channel, size_t numSamples,
+	const SampleType* inputRamp, const SampleType* outputRamp, const SampleType* gain)
+{
+	if (allButtonsMode)
+		shapeKernel<true>(samples, channel, numSamples, inputRamp, outputRamp, gain);
 	else
-		saturatedPart = std::tanh(drive * (scaledInput + asym * scaledInput));
+		shapeKernel<false>(samples, channel, numSamples, inputRamp, outputRamp, gain);
+}
 
-	float blend = std::min(std::abs(scaledInput) * drive, 1.0f);
-	float result = (1.0f - blend) * linearPart + blend * saturatedPart;
-	return result * threshold;
+// Base-rate GR to the oversampled rate: linear between neighbouring
+// detector samples. gains[0..sidechainDelay) carries the previous block's
+// tail, which both supplies the right-hand neighbour and delays the GR to
+// line up with the upsampling filter's latency.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::interpolateSidechainGain(int channel, size_t numBaseSamples)
+{
+	SampleType* gains = sidechainGain.getWritePointer(channel);
+	SampleType* target = gainBuffer.getWritePointer(channel);
+	const int factor = static_cast<int>(overSamplingFactor);
+	const SampleType step = SampleType(1) / overSamplingFactor;
+	for (size_t n = 0; n < numBaseSamples; ++n)
+	{
+		const SampleType delta = gains[n + 1] - gains[n];
+		for (int k = 0; k < factor; ++k)
+			target[n * static_cast<size_t>(factor) + static_cast<size_t>(k)] = gains[n] + static_cast<SampleType>(k) * step * delta;
+	}
+	std::copy(gains + numBaseSamples, gains + numBaseSamples + sidechainDelay, gains);
 }
 
-// Adjust the saturateFET second variable for more/less colouration.
-void Compressor1176::initFETLookup()
+// Points linkInputs at each slot's sidechain signal. Max keeps the sign of
+// the loudest sample, so the FET's asymmetry in All-Buttons mode sees the
+// same waveform as dual mono would. A group with a single channel in the
+// block detects on that channel as it is.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::makeLinkInputs(const SampleType* const* channels, int blockChannels, size_t numSamples)
 {
-	fetLUT.resize(FET_LOOKUP_SIZE);
-	for (int i = 0; i < FET_LOOKUP_SIZE; ++i)
+	jassert(numSamples <= static_cast<size_t>(linkBuffer.getNumSamples()));
+	const int n = static_cast<int>(numSamples);
+	for (int slot = 0; slot < numLinkSlots; ++slot)
 	{
-		float x = -2.0f + 4.0f * (i / static_cast<float>(FET_LOOKUP_SIZE - 1));
-		fetLUT[i] = saturateFET(x, 0.5f);
+		// Members ascend, so those inside the block come first
+		const int* members = linkSlotMembers.data() + linkSlotStart[static_cast<size_t>(slot)];
+		const int* end = linkSlotMembers.data() + linkSlotStart[static_cast<size_t>(slot) + 1];
+		const int count = static_cast<int>(std::find_if(members, end, [=](int ch) { return ch >= blockChannels; }) - members);
+		if (count <= 1)
+		{
+			linkInputs[static_cast<size_t>(slot)] = count == 1 ? channels[members[0]] : zeroChannel.data();
+			continue;
+		}
+
+		SampleType* link = linkBuffer.getWritePointer(slot);
+		juce::FloatVectorOperations::copy(link, channels[members[0]], n);
+		if (linkMode == LinkMode::sum)
+		{
+			for (int k = 1; k < count; ++k)
+				juce::FloatVectorOperations::add(link, channels[members[k]], n);
+			juce::FloatVectorOperations::multiply(link, SampleType(1) / static_cast<SampleType>(count), n);
+		}
+		else
+		{
+			for (int k = 1; k < count; ++k)
+			{
+				const SampleType* channel = channels[members[k]];
+				for (size_t i = 0; i < numSamples; ++i)
+					link[i] = std::abs(channel[i]) > std::abs(link[i]) ? channel[i] : link[i];
+			}
+		}
+		linkInputs[static_cast<size_t>(slot)] = link;
 	}
 }
 
-float Compressor1176::cubicInterpolate(float y0, float y1, float y2, float y3, float x)
+// Every slot's sidechain, then every channel meters its group's GR. Going
+// down the channels reads each slot before anything is written over it.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::detectLinked(int blockChannels, size_t numSamples, const SampleType* inputRamp,
+	size_t rampStride, juce::AudioBuffer<SampleType>& gains, int gainOffset)
+{
+	for (int slot = 0; slot < numLinkSlots; ++slot)
+		detectChannel(linkInputs[static_cast<size_t>(slot)], slot, numSamples, inputRamp, rampStride,
+			gains.getWritePointer(slot, gainOffset));
+	for (int ch = blockChannels - 1; ch > 0; --ch)
+		blockMinGain[static_cast<size_t>(ch)] = blockMinGain[static_cast<size_t>(linkSlot[static_cast<size_t>(ch)])];
+}
+
+// Silence is judged after the input gain, which can add up to 52 dB
+template <typename SampleType>
+bool BasicCompressor1176<SampleType>::isSilent(const juce::AudioBuffer<SampleType>& buffer) const
 {
-	float a = (-0.5f * y0) + (1.5f * y1) - (1.5f * y2) + (0.5f * y3);
-	float b = y0 - (2.5f * y1) + (2.0f * y2) - (0.5f * y3);
-	float c = (-0.5f * y0) + (0.5f * y2);
-	float d = y1;
-	return a * x * x * x + b * x * x + c * x + d;
+	const SampleType maxInputGain = std::max(inputGainSmoothed.getCurrentValue(), inputGainSmoothed.getTargetValue());
+	return buffer.getMagnitude(0, buffer.getNumSamples()) * maxInputGain < silenceThreshold;
+}
+
+// Split-rate sidechain: runs on the host-rate block before it is upsampled
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::detectHostRate(const juce::AudioBuffer<SampleType>& buffer, const SampleType* inputRamp)
+{
+	const int blockChannels = buffer.getNumChannels();
+	const size_t numBaseSamples = static_cast<size_t>(buffer.getNumSamples());
+	if (isLinked(blockChannels))
+	{
+		makeLinkInputs(buffer.getArrayOfReadPointers(), blockChannels, numBaseSamples);
+		detectLinked(blockChannels, numBaseSamples, inputRamp, static_cast<size_t>(overSamplingFactor), sidechainGain, sidechainDelay);
+		for (int slot = 0; slot < numLinkSlots; ++slot)
+			interpolateSidechainGain(slot, numBaseSamples);
+		return;
+	}
+	for (int ch = 0; ch < blockChannels; ++ch)
+	{
+		detectChannel(buffer.getReadPointer(ch), ch, numBaseSamples, inputRamp, static_cast<size_t>(overSamplingFactor),
+			sidechainGain.getWritePointer(ch, sidechainDelay));
+		interpolateSidechainGain(ch, numBaseSamples);
+	}
 }
 
-float Compressor1176::lookupFET(float x)
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::process(juce::AudioBuffer<SampleType>& buffer)
 {
-	if (fetLUT.size() < 4)
-		return 0.0f;
+	juce::dsp::AudioBlock<SampleType> inputBlock(buffer);
+	const size_t numBaseSamples = inputBlock.getNumSamples();
+	const size_t numSamples = numBaseSamples * static_cast<size_t>(overSamplingFactor);
+
+	const bool inputSilent = isSilent(buffer);
+	if (idle && inputSilent)
+	{
+		inputGainSmoothed.skip(static_cast<int>(numSamples));
+		outputGainSmoothed.skip(static_cast<int>(numSamples));
+		buffer.clear();
+		std::fill(blockMinGain.begin(), blockMinGain.end(), 1.0f);
+		return;
+	}
+	if (idle)
+		wakeFromIdle();
+	if (shaperStale)
+	{
+		overSampling->reset();
+		lookaheadDelay.reset();
+		shaperStale = false;
+	}
+	const int blockChannels = static_cast<int>(inputBlock.getNumChannels());
+	jassert(blockChannels <= numChannels);
+	const SampleType* inputRamp = fillGainRamp(inputGainSmoothed, inputGainRamp, numSamples) ? inputGainRamp.data() : nullptr;
+	const SampleType* outputRamp = fillGainRamp(outputGainSmoothed, outputGainRamp, numSamples) ? outputGainRamp.data() : nullptr;
+
+	if (splitRateDetector)
+		detectHostRate(buffer, inputRamp);
+
+	juce::dsp::AudioBlock<SampleType> oversampledBlock = overSampling->processSamplesUp(inputBlock);
+	jassert(oversampledBlock.getNumSamples() == numSamples);
+
+	// Linked: one sidechain pass for every group, before any channel is shaped
+	const bool linked = isLinked(blockChannels);
+	if (linked && !splitRateDetector)
+	{
+		for (int ch = 0; ch < blockChannels; ++ch)
+			linkChannels[static_cast<size_t>(ch)] = oversampledBlock.getChannelPointer(static_cast<size_t>(ch));
+		makeLinkInputs(linkChannels.data(), blockChannels, numSamples);
+		detectLinked(blockChannels, numSamples, inputRamp, 1, gainBuffer, 0);
+	}
+
+	// With lookahead every channel's sidechain runs on the block before the
+	// audio goes through the delay; without, each channel detects and shapes
+	// in one pass while it is in cache
+	const bool detectPerChannel = !splitRateDetector && !linked;
+	auto runChannels = [&](bool detect, bool shape) {
+		for (int ch = 0; ch < blockChannels; ++ch)
+		{
+			SampleType* samples = oversampledBlock.getChannelPointer(static_cast<size_t>(ch));
+			SampleType* gain = gainBuffer.getWritePointer(getGainSlot(ch, linked, blockChannels));
+			if (detect)
+				detectChannel(samples, ch, numSamples, inputRamp, 1, gain);
+			if (shape)
+				shapeChannel(samples, ch, numSamples, inputRamp, outputRamp, gain);
+		}
+	};
+	if (lookaheadSamples > 0)
+	{
+		if (detectPerChannel)
+			runChannels(true, false);
+		lookaheadDelay.process(oversampledBlock);
+		runChannels(false, true);
+	}
+	else
+		runChannels(detectPerChannel, true);
 
-	x = std::clamp(x, -2.0f, 2.0f);
-	float norm = (x + 2.0f) / 4.0f;
-	float index = norm * (FET_LOOKUP_SIZE - 1);
+	overSampling->processSamplesDown(inputBlock);
 
-	int i1 = static_cast<int>(index);
-	float frac = index - i1;
-	int i0 = std::max(0, i1 - 1);
-	int i2 = std::min(i1 + 1, FET_LOOKUP_SIZE - 1);
-	int i3 = std::min(i1 + 2, FET_LOOKUP_SIZE - 1);
+	// Past the latency the output is this silent input run, so once it is
+	// silent too the oversampler has drained
+	silentSamples = inputSilent ? std::min(silentSamples + static_cast<int>(numBaseSamples), latencySamples + 1) : 0;
+	idle = silentSamples > latencySamples
+		&& buffer.getMagnitude(0, buffer.getNumSamples()) < silenceThreshold
+		&& isSettled();
+}
 
-	return cubicInterpolate(fetLUT[i0], fetLUT[i1], fetLUT[i2], fetLUT[i3], frac);
+// Only the sidechain runs; the oversampler and shelves are left behind and
+// restart from silence at the next process(), under the bypass crossfade.
+// Without the split-rate detector, a zero-order hold stands in for the
+// upsampling filter.
+template <typename SampleType>
+void BasicCompressor1176<SampleType>::processSidechain(const juce::AudioBuffer<SampleType>& buffer)
+{
+	const size_t numBaseSamples = static_cast<size_t>(buffer.getNumSamples());
+	const size_t numSamples = numBaseSamples * static_cast<size_t>(overSamplingFactor);
+	const int blockChannels = buffer.getNumChannels();
+	jassert(blockChannels <= numChannels);
+	if (!shaperStale)
+	{
+		shaperStale = true;
+		for (int k = 0; k < 2; ++k)
+		{
+			std::fill(lowShelfState[k].begin(), lowShelfState[k].end(), 0.0f);
+			std::fill(highShelfState[k].begin(), highShelfState[k].end(), 0.0f);
+		}
+	}
+
+	outputGainSmoothed.skip(static_cast<int>(numSamples));
+	const bool inputSilent = isSilent(buffer);
+	if (idle && inputSilent)
+	{
+		inputGainSmoothed.skip(static_cast<int>(numSamples));
+		return;
+	}
+	if (idle)
+		wakeFromIdle();
+
+	const SampleType* inputRamp = fillGainRamp(inputGainSmoothed, inputGainRamp, numSamples) ? inputGainRamp.data() : nullptr;
+	const size_t factor = static_cast<size_t>(overSamplingFactor);
+	if (splitRateDetector)
+		detectHostRate(buffer, inputRamp);
+	else if (isLinked(blockChannels))
+	{
+		makeLinkInputs(buffer.getArrayOfReadPointers(), blockChannels, numBaseSamples);
+		for (int slot = 0; slot < numLinkSlots; ++slot)
+		{
+			const SampleType* link = linkInputs[static_cast<size_t>(slot)];
+			SampleType* held = heldInput.getWritePointer(slot);
+			for (size_t n = 0; n < numBaseSamples; ++n)
+				std::fill(held + n * factor, held + (n + 1) * factor, link[n]);
+			linkInputs[static_cast<size_t>(slot)] = held;
+		}
+		detectLinked(blockChannels, numSamples, inputRamp, 1, gainBuffer, 0);
+	}
+	else
+	{
+		for (int ch = 0; ch < blockChannels; ++ch)
+		{
+			const SampleType* source = buffer.getReadPointer(ch);
+			SampleType* held = heldInput.getWritePointer(ch);
+			for (size_t n = 0; n < numBaseSamples; ++n)
+				std::fill(held + n * factor, held + (n + 1) * factor, source[n]);
+			detectChannel(held, ch, numSamples, inputRamp, 1, gainBuffer.getWritePointer(ch));
+		}
+	}
+	// The meter rests while bypassed
+	std::fill(blockMinGain.begin(), blockMinGain.end(), 1.0f);
+
+	silentSamples = inputSilent ? std::min(silentSamples + static_cast<int>(numBaseSamples), latencySamples + 1) : 0;
+	idle = silentSamples > latencySamples && isSettled();
 }
+
+template class BasicCompressor1176<float>;
+template class BasicCompressor1176<double>;
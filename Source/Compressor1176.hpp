@@ -1,12 +1,41 @@
 #pragma once
 #include <JuceHeader.h>
+#include "LogIndexedTable.hpp"
+#include "GainComputer.hpp"
+#include "ShelfCoefficientBank.hpp"
+#include "FETShaper.hpp"
+#include "SlidingWindowMax.hpp"
+#include "DryDelayLine.hpp"
 
-static constexpr int FET_LOOKUP_SIZE = 1024;
+// Types and limits shared by the float and double engines
+struct Compressor1176Base
+{
+	// How channels share the sidechain. Linked modes run one detector,
+	// gain computer and ballistics pass per link group on the group's
+	// combined signal and apply its GR to every channel in the group, so the
+	// image within the group holds still.
+	enum class LinkMode
+	{
+		dualMono, // every channel compresses on its own
+		max,      // driven by whichever channel is loudest at each sample
+		sum       // driven by the mean of the channels
+	};
+
+	static constexpr float maxLookaheadMs = 5.0f;
+	// Widest layout the plugin accepts; the engine itself has no limit
+	static constexpr int maxChannels = 16;
+};
 
-class Compressor1176
+// The engine, for float or double audio. The audio path and all of its
+// state (oversampler, FET table, shelves, envelopes, GR) run in SampleType;
+// the tabulated gain curves and time-constant table are shared and stay in
+// float, their error is already well under their own tolerance.
+// Instantiated for float and double in Compressor1176.cpp.
+template <typename SampleType>
+class BasicCompressor1176 : public Compressor1176Base
 {
 	public:
-		Compressor1176();
+		BasicCompressor1176();
 
 		void setInputGain(float newInputGain);
 		void setRatio(float newRatio);
@@ -14,62 +43,173 @@ class Compressor1176
 		void setRelease(float knobValue);
 		void setOutputGain(float newOutputGain);
 		void setAllButtons(bool newValue);
+		// Takes effect at the next prepare(); stages 0..3 = 1x..8x
+		void setOversampling(int newStages, bool newLinearPhase);
+		// Takes effect at the next prepare(); runs detector, gain computer and
+		// GR ballistics at the host rate, oversampling only the FET, shelves
+		// and soft clip
+		void setSplitRateDetector(bool newValue);
+		// Call between blocks; the detector state carries over
+		void setLinkMode(LinkMode newMode);
+		// Takes effect at the next prepare(). One group number per channel:
+		// channels with the same number above zero share a detector when
+		// linked, 0 leaves a channel on its own, as do channels past the end
+		// of the list. Empty (the default) puts every channel in one group.
+		void setLinkGroups(std::vector<int> newGroups);
+		// Takes effect at the next prepare(). Delays the audio by up to
+		// maxLookaheadMs (added to the latency) while the detector follows the
+		// loudest sample inside that window, so transients meet GR that has
+		// already moved.
+		void setLookahead(float newLookaheadMs);
 
-		float getSmoothingCoeff(float timeMs);
-		float getThreshold();
-		float mapAttackMs(float knobValue);
-		float mapReleaseMs(float knobValue);
+		SampleType getSmoothingCoeff(float timeMs);
+		void updateSmoothingCoeffs();
+		float mapAttackMs(float knobValue) const;
+		float mapReleaseMs(float knobValue) const;
 
 		// float processRMS(int ch, float sample);
-		float processPeak(int ch, float sample);
 		void prepare(const juce::dsp::ProcessSpec& spec);
 		void reset();
 
-		float getRatio();
-
-		void process(juce::AudioBuffer<float>& buffer);
+		void process(juce::AudioBuffer<SampleType>& buffer);
+		// Bypassed but warm: advances the detector and GR over the block and
+		// leaves the audio untouched
+		void processSidechain(const juce::AudioBuffer<SampleType>& buffer);
 
-		// Fet
-		float saturateFET(float x, float drive);
-		void initFETLookup();
-		float cubicInterpolate(float y0, float y1, float y2, float y3, float x);
-		float lookupFET(float x);
-		float softClip(float x);
-
-		float getGainReductionDb() const { return lastGainReductionDb.load(); }
+		// Lowest GR applied to channel over the last block, as linear gain (1 = no GR)
+		float getBlockMinGain(int channel) const { return static_cast<float>(blockMinGain[static_cast<size_t>(channel)]); }
+		int getLatencySamples() const { return latencySamples; }
+		double getTailLengthSeconds() const;
+		bool isIdle() const { return idle; }
 	private:
-		// GR for VU Meter
-		std::atomic<float> lastGainReductionDb = 0.f;
+		// GR for VU Meter, read on the audio thread after process()
+		std::vector<SampleType> blockMinGain;
 		// Settings for allButtonsMode
 		bool allButtonsMode = false;
-		float ratioModulation = 0.0f;
-		std::vector<float> transientDetector;
-		std::vector<float> slowEnvelope;
+		std::vector<SampleType> ratioModulation;
+		std::vector<SampleType> transientDetector;
+		std::vector<SampleType> slowEnvelope;
 
 		float inputGain = 0.0f;
 		float outputGain = 0.0f;
+		// Linear gains, retargeted once per block and ramped per oversampled sample
+		using SmoothedGain = juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Multiplicative>;
+		SmoothedGain inputGainSmoothed { 1 };
+		SmoothedGain outputGainSmoothed { 1 };
+		std::vector<SampleType> inputGainRamp;
+		std::vector<SampleType> outputGainRamp;
+		static constexpr double gainRampSeconds = 0.02;
 		float ratio = 4.0f;
 		float attackTime = 0.5f;
 		float releaseTime = 600.0f;
-		std::vector<float> smoothedGainReduction;
+		std::vector<SampleType> smoothedGainReduction;
 		int numChannels = 2;
+		// Sidechain input of a link group with no channel in the block
+		std::vector<SampleType> zeroChannel;
 
 		double sampleRate = 44100.0;
+		int overSamplingStages = 2;
+		bool linearPhaseOverSampling = false;
 		float overSamplingFactor = 4.0f;
-		double overSampledRate;
-
-		std::vector<float> envelope;
-		std::vector<juce::dsp::IIR::Filter<float>> lowShelfFilter;
-		std::vector<juce::dsp::IIR::Filter<float>> highShelfFilter;
-		std::vector<float> lastBoostDb;
-		std::vector<float> fetLUT;
-		std::vector<float> compressionHistory;
-
-		juce::dsp::Oversampling<float> overSampling {
-			2,
-			2,
-			juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR
-		};
-
-		float computeGainReduction(float level);
+		double overSampledRate = 0.0;
+		int latencySamples = 0;
+		bool splitRateRequested = false;
+		bool splitRateDetector = false;
+		// Rate the sidechain runs at, and so the rate of every one-pole below
+		double detectorRate = 0.0;
+		int sidechainDelay = 0;
+		// Linked, each link group runs one sidechain in a slot of its own.
+		// Slots are numbered in order of their group's first channel, so a
+		// slot's index is never above that of any channel it serves; the
+		// sidechain state and gain buffers hold slots in place of channels.
+		LinkMode linkMode = LinkMode::dualMono;
+		std::vector<int> linkGroups;
+		int numLinkSlots = 1;
+		std::vector<int> linkSlot;        // by channel
+		std::vector<int> linkSlotStart;   // into linkSlotMembers, by slot, plus the end
+		std::vector<int> linkSlotMembers;
+		// Per slot: the group's combined signal, or its only channel
+		juce::AudioBuffer<SampleType> linkBuffer;
+		std::vector<const SampleType*> linkInputs;
+		std::vector<const SampleType*> linkChannels;
+
+		// Lookahead in whole host samples, so the latency stays an integer.
+		// The audio is delayed at the oversampled rate; the peak windows span
+		// the same time at the detector rate.
+		float lookaheadMs = 0.0f;
+		int lookaheadSamples = 0;
+		DryDelayLine<SampleType> lookaheadDelay;
+		std::vector<SlidingWindowMax<SampleType>> peakWindows;
+		// Per-sample GR at the oversampled rate; in split-rate mode the
+		// detector writes host-rate GR into sidechainGain first
+		juce::AudioBuffer<SampleType> gainBuffer;
+		juce::AudioBuffer<SampleType> sidechainGain;
+		// Zero-order-held input for processSidechain() at the oversampled rate
+		juce::AudioBuffer<SampleType> heldInput;
+		// Set by processSidechain(): the oversampler holds stale audio
+		bool shaperStale = false;
+
+		// One-pole coefficients, rebuilt in prepare() and when attack/release change.
+		// Times that vary per sample (program-dependent release, All-Buttons
+		// modulation) read the interpolated table instead of calling std::exp.
+		LogIndexedTable<6> smoothingCoeffTable;
+		SampleType detectorAttackCoeff = 0;
+		SampleType detectorReleaseCoeff = 0;
+		SampleType transientFastCoeff = 0;
+		SampleType transientSlowCoeff = 0;
+		SampleType attackCoeff = 0;
+
+		std::vector<SampleType> envelope;
+		// Shelf biquads (TDF-II): two state words per channel, coefficients from
+		// the bank, both in double
+		ShelfCoefficientBank shelfBank;
+		std::array<std::vector<double>, 2> lowShelfState;
+		std::array<std::vector<double>, 2> highShelfState;
+		std::vector<SampleType> compressionHistory;
+		GainComputer gainComputer;
+
+		std::unique_ptr<juce::dsp::Oversampling<SampleType>> overSampling;
+
+		// Idle: the input has been silent long enough for the oversampler to
+		// drain and every envelope, the GR and the shelves to settle, so
+		// process() writes silence without running the chain.
+		static constexpr float silenceThreshold = 1.0e-5f; // -100 dB
+		static constexpr float idleGainReduction = 0.99f; // within 0.09 dB of unity
+		bool idle = false;
+		int silentSamples = 0;
+		bool isSettled() const;
+		bool isSilent(const juce::AudioBuffer<SampleType>& buffer) const;
+		void wakeFromIdle();
+
+		static bool fillGainRamp(SmoothedGain& gain, std::vector<SampleType>& ramp, size_t numSamples);
+
+		void detectChannel(const SampleType* in, int channel, size_t numSamples,
+			const SampleType* inputRamp, size_t rampStride, SampleType* gainOut);
+		void shapeChannel(SampleType* samples, int channel, size_t numSamples,
+			const SampleType* inputRamp, const SampleType* outputRamp, const SampleType* gain);
+		template <bool AllButtons, bool Lookahead>
+		void detectKernel(const SampleType* in, int channel, size_t numSamples,
+			const SampleType* inputRamp, size_t rampStride, SampleType* gainOut);
+		template <bool AllButtons>
+		void shapeKernel(SampleType* samples, int channel, size_t numSamples,
+			const SampleType* inputRamp, const SampleType* outputRamp, const SampleType* gain);
+		void interpolateSidechainGain(int channel, size_t numBaseSamples);
+		void detectHostRate(const juce::AudioBuffer<SampleType>& buffer, const SampleType* inputRamp);
+		// Groups of one channel each link to nothing, and run as dual mono
+		bool isLinked(int blockChannels) const
+		{
+			return linkMode != LinkMode::dualMono && blockChannels > 1 && numLinkSlots < numChannels;
+		}
+		int getGainSlot(int channel, bool linked, int blockChannels) const
+		{
+			return !linked ? channel : channel < blockChannels ? linkSlot[static_cast<size_t>(channel)] : 0;
+		}
+		void prepareLinkSlots();
+		void copySidechain(int from, int to);
+		void makeLinkInputs(const SampleType* const* channels, int blockChannels, size_t numSamples);
+		void detectLinked(int blockChannels, size_t numSamples, const SampleType* inputRamp, size_t rampStride,
+			juce::AudioBuffer<SampleType>& gains, int gainOffset);
 };
+
+using Compressor1176 = BasicCompressor1176<float>;
+using Compressor1176Double = BasicCompressor1176<double>;
@@ -0,0 +1,61 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Integer delay for the dry signal, so bypass (and anything else blended
+// with the wet path) lines up with the oversampler's reported latency. Also
+// the audio path of the compressor's lookahead. All storage is allocated in
+// prepare().
+template <typename SampleType>
+class DryDelayLine
+{
+	public:
+		void prepare(int numChannels, int newDelaySamples)
+		{
+			delaySamples = std::max(0, newDelaySamples);
+			ring.setSize(numChannels, std::max(1, delaySamples));
+			reset();
+		}
+
+		void reset()
+		{
+			ring.clear();
+			position = 0;
+		}
+
+		int getDelaySamples() const { return delaySamples; }
+
+		// Delays the first numSamples of every channel in place
+		void process(juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+		{
+			process(juce::dsp::AudioBlock<SampleType>(buffer).getSubBlock(0, static_cast<size_t>(numSamples)));
+		}
+
+		void process(const juce::dsp::AudioBlock<SampleType>& block) noexcept
+		{
+			if (delaySamples == 0)
+				return;
+			jassert(block.getNumChannels() <= static_cast<size_t>(ring.getNumChannels()));
+			const int numSamples = static_cast<int>(block.getNumSamples());
+			int end = position;
+			for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+			{
+				SampleType* samples = block.getChannelPointer(ch);
+				SampleType* line = ring.getWritePointer(static_cast<int>(ch));
+				int pos = position;
+				for (int i = 0; i < numSamples; ++i)
+				{
+					const SampleType input = samples[i];
+					samples[i] = line[pos];
+					line[pos] = input;
+					pos = pos + 1 == delaySamples ? 0 : pos + 1;
+				}
+				end = pos;
+			}
+			position = end;
+		}
+
+	private:
+		juce::AudioBuffer<SampleType> ring;
+		int delaySamples = 0;
+		int position = 0;
+};
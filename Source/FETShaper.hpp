@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+static constexpr int FET_LOOKUP_SIZE = 1024;
+
+// FET stage and output soft clip. The FET curve is generated at compile time
+// into one table shared by every instance. Each entry holds the Catmull-Rom
+// cubic of one segment, so a lookup is a single contiguous 16-byte read plus
+// a Horner step. There is one table per sample type; the double one is
+// built from the curve in double.
+//
+// Accuracy (checked by 1176Measure): lookup() matches the previous
+// per-instance table with cubicInterpolate() to within maxLookupError.
+// softClip() replaces std::tanh on the overshoot with a [7/6] Lambert
+// continued fraction, within maxSoftClipError of the std::tanh version
+// (-108 dB).
+struct FETShaper
+{
+	template <typename SampleType>
+	struct Segment
+	{
+		SampleType a, b, c, d;
+	};
+
+	static constexpr float inputRange = 2.0f;
+	static constexpr float clipThreshold = 0.98f;
+	static constexpr double maxLookupError = 3e-7;
+	static constexpr double maxSoftClipError = 4e-6;
+
+	template <typename SampleType>
+	static SampleType lookup(SampleType x) noexcept
+	{
+		constexpr auto range = static_cast<SampleType>(inputRange);
+		x = std::clamp(x, -range, range);
+		SampleType index = (x + range) * static_cast<SampleType>(indexScale);
+		int i = static_cast<int>(index);
+		SampleType frac = index - static_cast<SampleType>(i);
+		const Segment<SampleType>& s = table<SampleType>[static_cast<size_t>(i)];
+		return ((s.a * frac + s.b) * frac + s.c) * frac + s.d;
+	}
+
+	template <typename SampleType>
+	static SampleType softClip(SampleType x) noexcept
+	{
+		using T = SampleType;
+		T magnitude = std::abs(x);
+		T overshoot = std::min(std::max(magnitude - static_cast<T>(clipThreshold), T(0)), static_cast<T>(tanhSaturation));
+		T over2 = overshoot * overshoot;
+		T numerator = overshoot * (T(135135) + over2 * (T(17325) + over2 * (T(378) + over2)));
+		T denominator = T(135135) + over2 * (T(62370) + over2 * (T(3150) + over2 * T(28)));
+		T clipped = std::min(magnitude, static_cast<T>(clipThreshold)) + T(0.05) * (numerator / denominator);
+		return std::copysign(clipped, x);
+	}
+
+	// Smaller asym value equals less colouration, bigger more.
+	static constexpr double saturate(double x, double drive)
+	{
+		double threshold = 0.7;
+		double scaledInput = x / threshold;
+
+		double asym = 0.3;
+
+		double linearPart = scaledInput;
+		double saturatedPart = 0;
+
+		if (scaledInput >= 0.0)
+			saturatedPart = constexprTanh(drive * scaledInput);
+		else
+			saturatedPart = constexprTanh(drive * (scaledInput + asym * scaledInput));
+
+		double blend = std::min((scaledInput < 0 ? -scaledInput : scaledInput) * drive, 1.0);
+		double result = (1.0 - blend) * linearPart + blend * saturatedPart;
+		return result * threshold;
+	}
+
+	private:
+		static constexpr float indexScale = (FET_LOOKUP_SIZE - 1) / (2.0f * inputRange);
+		// Past this the continued fraction drifts from tanh; holding it here
+		// gives the smallest worst-case error
+		static constexpr float tanhSaturation = 4.8f;
+
+		static constexpr double constexprExp(double x)
+		{
+			// exp(x) = 2^k * exp(r), |r| <= ln2 / 2
+			constexpr double ln2 = 0.693147180559945309417;
+			int k = static_cast<int>(x / ln2 + (x < 0 ? -0.5 : 0.5));
+			double r = x - k * ln2;
+			double term = 1.0, sum = 1.0;
+			for (int n = 1; n < 14; ++n)
+			{
+				term *= r / n;
+				sum += term;
+			}
+			for (; k > 0; --k)
+				sum *= 2.0;
+			for (; k < 0; ++k)
+				sum *= 0.5;
+			return sum;
+		}
+
+		static constexpr double constexprTanh(double x)
+		{
+			double e = constexprExp(2.0 * x);
+			return (e - 1.0) / (e + 1.0);
+		}
+
+		// Adjust the saturate() drive for more/less colouration.
+		template <typename SampleType>
+		static constexpr std::array<Segment<SampleType>, FET_LOOKUP_SIZE> makeTable()
+		{
+			using T = SampleType;
+			std::array<T, FET_LOOKUP_SIZE> y {};
+			for (int i = 0; i < FET_LOOKUP_SIZE; ++i)
+			{
+				double x = -inputRange + 2.0 * inputRange * (i / static_cast<double>(FET_LOOKUP_SIZE - 1));
+				y[static_cast<size_t>(i)] = static_cast<T>(saturate(x, 0.5));
+			}
+
+			std::array<Segment<T>, FET_LOOKUP_SIZE> segments {};
+			for (int i = 0; i < FET_LOOKUP_SIZE; ++i)
+			{
+				T y0 = y[static_cast<size_t>(std::max(0, i - 1))];
+				T y1 = y[static_cast<size_t>(i)];
+				T y2 = y[static_cast<size_t>(std::min(i + 1, FET_LOOKUP_SIZE - 1))];
+				T y3 = y[static_cast<size_t>(std::min(i + 2, FET_LOOKUP_SIZE - 1))];
+				segments[static_cast<size_t>(i)] = {
+					(T(-0.5) * y0) + (T(1.5) * y1) - (T(1.5) * y2) + (T(0.5) * y3),
+					y0 - (T(2.5) * y1) + (T(2) * y2) - (T(0.5) * y3),
+					(T(-0.5) * y0) + (T(0.5) * y2),
+					y1
+				};
+			}
+			return segments;
+		}
+
+	public:
+		template <typename SampleType>
+		static const std::array<Segment<SampleType>, FET_LOOKUP_SIZE> table;
+};
+
+template <typename SampleType>
+inline constexpr std::array<FETShaper::Segment<SampleType>, FET_LOOKUP_SIZE> FETShaper::table = FETShaper::makeTable<SampleType>();
@@ -0,0 +1,96 @@
+#include "GainComputer.hpp"
+
+float GainComputer::getThreshold(float ratio)
+{
+	if (ratio == 4.0f)	return -15.f;
+	if (ratio == 8.0f)	return -10.8f;
+	if (ratio == 12.0f)	return -9.6f;
+	if (ratio == 20.0f)	return -7.6f;
+
+	return (-15.f);
+}
+
+float GainComputer::getAllButtonsThreshold(float modulation)
+{
+	float baseThreshold = -18.f;
+	return baseThreshold + modulation * 2.0f;
+}
+
+float GainComputer::getAllButtonsRatio(float modulation)
+{
+	float baseRatio = 16.0f;
+	float variation = modulation * 4.0f;
+	return std::clamp(baseRatio + variation, 12.0f, 20.0f);
+}
+
+float GainComputer::computeGain(float level, float thresholdDb, float ratio)
+{
+	float inputLevelDb = juce::Decibels::gainToDecibels(level + 1e-12f);
+	if (inputLevelDb <= thresholdDb)
+		return 1.0f;
+
+	float outputLevelDb = thresholdDb + (inputLevelDb - thresholdDb) / ratio;
+	float gainReductionDb = inputLevelDb - outputLevelDb;
+	gainReductionDb = std::clamp(gainReductionDb, 0.0f, 60.0f);
+	return juce::Decibels::decibelsToGain(-gainReductionDb);
+}
+
+// Spans the knee up to one octave past the 60 dB GR floor; anything louder
+// reads the last entry, which the floor clamp then pins.
+void GainComputer::Curve::build(float thresholdDb, float ratio)
+{
+	const double slope = 1.0 - 1.0 / ratio;
+	const float floorLevel = static_cast<float>(std::pow(10.0, 60.0 / 20.0 / slope));
+	table.build(1.0f, 2.0f * floorLevel, [slope](float x) {
+		return static_cast<float>(std::pow(static_cast<double>(x), -slope));
+	});
+	inverseThreshold = 1.0f / juce::Decibels::decibelsToGain(thresholdDb);
+}
+
+void GainComputer::prepare()
+{
+	for (size_t i = 0; i < ratios.size(); ++i)
+		fixedCurves[i].build(getThreshold(ratios[i]), ratios[i]);
+	for (int row = 0; row < numModulationRows; ++row)
+	{
+		float modulation = minModulation + static_cast<float>(row) / rowsPerModulation;
+		modulatedCurves[static_cast<size_t>(row)].build(getAllButtonsThreshold(modulation), getAllButtonsRatio(modulation));
+	}
+}
+
+void GainComputer::setRatio(float newRatio)
+{
+	fixedCurve = &fixedCurves[0];
+	for (size_t i = 0; i < ratios.size(); ++i)
+		if (ratios[i] == newRatio)
+			fixedCurve = &fixedCurves[i];
+}
+
+float GainComputer::measureMaxErrorDb(bool allButtons) const
+{
+	auto errorDb = [](float gain, float reference) {
+		return std::abs(juce::Decibels::gainToDecibels(gain, -200.0f) - juce::Decibels::gainToDecibels(reference, -200.0f));
+	};
+
+	float worst = 0.0f;
+	for (float levelDb = -80.0f; levelDb <= 80.0f; levelDb += 0.05f)
+	{
+		float level = juce::Decibels::decibelsToGain(levelDb);
+		if (!allButtons)
+		{
+			for (size_t i = 0; i < ratios.size(); ++i)
+			{
+				const Curve& curve = fixedCurves[i];
+				float gain = std::clamp(curve.table(level * curve.inverseThreshold), minGain, 1.0f);
+				worst = std::max(worst, errorDb(gain, computeGain(level, getThreshold(ratios[i]), ratios[i])));
+			}
+		}
+		else
+		{
+			for (float modulation = minModulation; modulation <= maxModulation; modulation += 0.02f)
+				worst = std::max(worst, errorDb(getGain(level, modulation),
+					computeGain(level, getAllButtonsThreshold(modulation), getAllButtonsRatio(modulation))));
+		}
+	}
+	return worst;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <JuceHeader.h>
+#include "LogIndexedTable.hpp"
+
+// Static transfer curves of the four ratio buttons and of All-Buttons mode,
+// tabulated in prepare() so the per-sample gain computer is a table read
+// instead of a log10 and a pow.
+//
+// Each table holds the pure power law (level / threshold)^-(1 - 1/ratio),
+// indexed by the threshold-normalised level with 16 segments per octave; the
+// knee (0 dB GR) and the 60 dB GR floor are applied as clamps after the read,
+// so no kink falls inside a segment. All-Buttons mode keeps one table per
+// 1/16 step of ratio modulation and blends the two nearest.
+//
+// Accuracy against computeGain() for detector levels -80..+80 dBFS, checked
+// by 1176Measure:
+//   ratio buttons  < 0.01 dB
+//   All-Buttons    < 0.03 dB (blending across the moving knee dominates)
+class GainComputer
+{
+	public:
+		static constexpr float maxErrorDb = 0.01f;
+		static constexpr float maxModulatedErrorDb = 0.03f;
+
+		void prepare();
+		void setRatio(float newRatio);
+
+		float getGain(float level) const noexcept
+		{
+			return std::clamp(fixedCurve->table(level * fixedCurve->inverseThreshold), minGain, 1.0f);
+		}
+
+		// All-Buttons curve at the given ratio modulation (-0.5 .. 0.5)
+		float getGain(float level, float modulation) const noexcept
+		{
+			float position = (std::clamp(modulation, minModulation, maxModulation) - minModulation) * rowsPerModulation;
+			int row = std::min(static_cast<int>(position), numModulationRows - 2);
+			float frac = position - static_cast<float>(row);
+			const Curve& a = modulatedCurves[static_cast<size_t>(row)];
+			const Curve& b = modulatedCurves[static_cast<size_t>(row) + 1];
+			float gainA = std::clamp(a.table(level * a.inverseThreshold), minGain, 1.0f);
+			float gainB = std::clamp(b.table(level * b.inverseThreshold), minGain, 1.0f);
+			return gainA + frac * (gainB - gainA);
+		}
+
+		static float getThreshold(float ratio);
+		static float getAllButtonsThreshold(float modulation);
+		static float getAllButtonsRatio(float modulation);
+
+		// Reference curve the tables are measured against
+		static float computeGain(float level, float thresholdDb, float ratio);
+
+		// Worst deviation from computeGain() over a level sweep, in dB. A
+		// dense sweep of log/pow; for the measurement harness, not prepare().
+		float measureMaxErrorDb(bool allButtons) const;
+
+	private:
+		struct Curve
+		{
+			LogIndexedTable<4> table;
+			float inverseThreshold = 1.0f;
+			void build(float thresholdDb, float ratio);
+		};
+
+		static constexpr float minGain = 0.001f; // 60 dB GR
+		static constexpr float minModulation = -0.5f;
+		static constexpr float maxModulation = 0.5f;
+		static constexpr int numModulationRows = 17;
+		static constexpr float rowsPerModulation = (numModulationRows - 1) / (maxModulation - minModulation);
+		static constexpr std::array<float, 4> ratios { 4.0f, 8.0f, 12.0f, 20.0f };
+
+		std::array<Curve, ratios.size()> fixedCurves;
+		std::array<Curve, numModulationRows> modulatedCurves;
+		const Curve* fixedCurve = &fixedCurves[0];
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Which channels share a detector when the compressor is linked, as one
+// group number per channel in the form BasicCompressor1176::setLinkGroups()
+// takes: channels with the same number above zero are linked, 0 leaves a
+// channel on its own.
+namespace LinkGroups
+{
+	// Every channel in one group, as stereo link has always worked
+	inline std::vector<int> allLinked(int numChannels) { return std::vector<int>(static_cast<size_t>(numChannels), 1); }
+
+	// Fronts, surrounds and heights link among themselves and the LFEs stay
+	// on their own; channels with no position (discrete layouts) share a
+	// fourth group
+	inline std::vector<int> fromSpeakerPositions(const juce::AudioChannelSet& layout)
+	{
+		enum { own, fronts, surrounds, heights, unpositioned };
+		std::vector<int> groups;
+		for (auto type : layout.getChannelTypes())
+		{
+			switch (type)
+			{
+				case juce::AudioChannelSet::left:
+				case juce::AudioChannelSet::right:
+				case juce::AudioChannelSet::centre:
+				case juce::AudioChannelSet::leftCentre:
+				case juce::AudioChannelSet::rightCentre:
+				case juce::AudioChannelSet::wideLeft:
+				case juce::AudioChannelSet::wideRight:
+					groups.push_back(fronts);
+					break;
+				case juce::AudioChannelSet::leftSurround:
+				case juce::AudioChannelSet::rightSurround:
+				case juce::AudioChannelSet::centreSurround:
+				case juce::AudioChannelSet::leftSurroundSide:
+				case juce::AudioChannelSet::rightSurroundSide:
+				case juce::AudioChannelSet::leftSurroundRear:
+				case juce::AudioChannelSet::rightSurroundRear:
+					groups.push_back(surrounds);
+					break;
+				case juce::AudioChannelSet::topMiddle:
+				case juce::AudioChannelSet::topFrontLeft:
+				case juce::AudioChannelSet::topFrontCentre:
+				case juce::AudioChannelSet::topFrontRight:
+				case juce::AudioChannelSet::topRearLeft:
+				case juce::AudioChannelSet::topRearCentre:
+				case juce::AudioChannelSet::topRearRight:
+				case juce::AudioChannelSet::topSideLeft:
+				case juce::AudioChannelSet::topSideRight:
+					groups.push_back(heights);
+					break;
+				case juce::AudioChannelSet::LFE:
+				case juce::AudioChannelSet::LFE2:
+					groups.push_back(own);
+					break;
+				default:
+					groups.push_back(unpositioned);
+					break;
+			}
+		}
+		return groups;
+	}
+
+	// "1 1 1 0 2 2" (or comma separated), one number per channel; anything
+	// that is not a number, and any channel past the end, is on its own
+	inline std::vector<int> fromString(const juce::String& text, int numChannels)
+	{
+		auto tokens = juce::StringArray::fromTokens(text, " ,", "");
+		tokens.removeEmptyStrings();
+		std::vector<int> groups(static_cast<size_t>(numChannels), 0);
+		for (int ch = 0; ch < juce::jmin(numChannels, tokens.size()); ++ch)
+			groups[static_cast<size_t>(ch)] = juce::jmax(0, tokens[ch].getIntValue());
+		return groups;
+	}
+
+	inline juce::String toString(const std::vector<int>& groups)
+	{
+		juce::StringArray tokens;
+		for (int group : groups)
+			tokens.add(juce::String(group));
+		return tokens.joinIntoString(" ");
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Table of a smooth function over a positive range, indexed straight from the
+// IEEE-754 bit pattern of the argument. Every octave is split into
+// 2^MantissaBits linearly spaced segments, so a lookup is a shift, a mask and
+// one linear interpolation: no log is needed to find the segment.
+// Relative interpolation error is roughly f''/f * (x / 2^MantissaBits)^2 / 8.
+template <int MantissaBits>
+class LogIndexedTable
+{
+	public:
+		template <typename Function>
+		void build(float minX, float maxX, Function&& function)
+		{
+			jassert(minX > 0.0f && maxX > minX);
+			firstBits = toBits(minX) & ~segmentMask;
+			lastBits = toBits(maxX);
+			const int numSegments = static_cast<int>((lastBits - firstBits) >> segmentShift) + 1;
+			table.resize(static_cast<size_t>(numSegments) + 1);
+			for (int i = 0; i <= numSegments; ++i)
+				table[static_cast<size_t>(i)] = function(fromBits(firstBits + (static_cast<uint32_t>(i) << segmentShift)));
+		}
+
+		// Arguments outside [minX, maxX] are clamped, negative ones read the first entry.
+		float operator()(float x) const noexcept
+		{
+			uint32_t bits = toBits(x);
+			if (bits > lastBits)
+				bits = (bits & signBit) ? firstBits : lastBits;
+			bits = std::max(bits, firstBits) - firstBits;
+			const auto index = static_cast<size_t>(bits >> segmentShift);
+			const float frac = static_cast<float>(bits & segmentMask) * fracScale;
+			return table[index] + frac * (table[index + 1] - table[index]);
+		}
+
+		bool isEmpty() const noexcept { return table.empty(); }
+
+	private:
+		static constexpr uint32_t segmentShift = 23 - MantissaBits;
+		static constexpr uint32_t segmentMask = (1u << segmentShift) - 1u;
+		static constexpr uint32_t signBit = 0x80000000u;
+		static constexpr float fracScale = 1.0f / static_cast<float>(1u << segmentShift);
+
+		static uint32_t toBits(float x) noexcept
+		{
+			uint32_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			return bits;
+		}
+
+		static float fromBits(uint32_t bits) noexcept
+		{
+			float x;
+			std::memcpy(&x, &bits, sizeof(x));
+			return x;
+		}
+
+		uint32_t firstBits = 0;
+		uint32_t lastBits = 0;
+		std::vector<float> table;
+};
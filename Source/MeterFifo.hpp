@@ -0,0 +1,48 @@
+#pragma once
+#include <JuceHeader.h>
+
+// One processed block, as seen by the GR meter: each channel's lowest gain
+// over the block, linear (1 = no GR).
+struct MeterFrame
+{
+	static constexpr int maxChannels = 16;
+
+	int numChannels = 0;
+	float seconds = 0.0f;
+	std::array<float, maxChannels> minGain {};
+};
+
+// Wait-free single-producer/single-consumer ring of meter frames: the audio
+// thread pushes one frame per block, the editor drains whatever arrived
+// since its last tick. Frames live in a fixed array, and a push into a full
+// ring (no editor open) drops the frame rather than waiting.
+class MeterFifo
+{
+	public:
+		static constexpr int capacity = 512;
+
+		bool push(const MeterFrame& frame) noexcept
+		{
+			const auto scope = fifo.write(1);
+			if (scope.blockSize1 + scope.blockSize2 == 0)
+				return false;
+			frames[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = frame;
+			return true;
+		}
+
+		// Calls fn(const MeterFrame&) for every pending frame, oldest first
+		template <typename Function>
+		int popAll(Function&& fn)
+		{
+			const auto scope = fifo.read(fifo.getNumReady());
+			for (int i = 0; i < scope.blockSize1; ++i)
+				fn(frames[static_cast<size_t>(scope.startIndex1 + i)]);
+			for (int i = 0; i < scope.blockSize2; ++i)
+				fn(frames[static_cast<size_t>(scope.startIndex2 + i)]);
+			return scope.blockSize1 + scope.blockSize2;
+		}
+
+	private:
+		juce::AbstractFifo fifo { capacity };
+		std::array<MeterFrame, capacity> frames;
+};
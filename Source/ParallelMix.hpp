@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Dry/wet blend for parallel compression against the latency-aligned dry
+// path. The blend is linear, since dry and wet are correlated, and mix
+// changes ramp over 20 ms. All storage is allocated in prepare().
+template <typename SampleType>
+class ParallelMix
+{
+	public:
+		void prepare(double sampleRate, int maximumBlockSize)
+		{
+			mix.reset(sampleRate, 0.02);
+			mix.setCurrentAndTargetValue(mix.getTargetValue());
+			ramp.resize(static_cast<size_t>(maximumBlockSize));
+		}
+
+		// 0 is all dry, 1 all wet
+		void setMix(float newMix) { mix.setTargetValue(static_cast<SampleType>(juce::jlimit(0.0f, 1.0f, newMix))); }
+
+		bool isFullyWet() const { return !mix.isSmoothing() && mix.getTargetValue() >= SampleType(1); }
+
+		// wet = dry + mix * (wet - dry) over the first numSamples
+		void process(juce::AudioBuffer<SampleType>& wet, const juce::AudioBuffer<SampleType>& dry, int numSamples) noexcept
+		{
+			if (isFullyWet())
+				return;
+			jassert(static_cast<size_t>(numSamples) <= ramp.size());
+
+			const bool smoothing = mix.isSmoothing();
+			if (smoothing)
+				for (int i = 0; i < numSamples; ++i)
+					ramp[static_cast<size_t>(i)] = mix.getNextValue();
+			const SampleType steadyMix = mix.getTargetValue();
+
+			for (int ch = 0; ch < wet.getNumChannels(); ++ch)
+			{
+				SampleType* out = wet.getWritePointer(ch);
+				const SampleType* in = dry.getReadPointer(ch);
+				juce::FloatVectorOperations::subtract(out, in, numSamples);
+				if (smoothing)
+					juce::FloatVectorOperations::multiply(out, ramp.data(), numSamples);
+				else
+					juce::FloatVectorOperations::multiply(out, steadyMix, numSamples);
+				juce::FloatVectorOperations::add(out, in, numSamples);
+			}
+		}
+
+	private:
+		juce::SmoothedValue<SampleType> mix { 1 };
+		std::vector<SampleType> ramp;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <JuceHeader.h>
+
+// One dirty bit per watched parameter. Listeners may fire on any thread
+// (host automation, the editor, state restore) and only set a bit; the
+// audio thread takes the whole word at the start of a block and re-reads
+// just the parameters whose bits were set. Everything starts dirty so the
+// first block reads every parameter; markAllDirty() does the same after a
+// re-prepare or a state restore.
+class ParameterDirtyFlags
+{
+	public:
+		~ParameterDirtyFlags()
+		{
+			for (auto& watcher : watchers)
+				watcher->parameter.removeListener(watcher.get());
+		}
+
+		void watch(juce::AudioProcessorParameter& parameter, int bit)
+		{
+			jassert(bit >= 0 && bit < 32);
+			watchers.push_back(std::make_unique<Watcher>(parameter, dirty, 1u << bit));
+			parameter.addListener(watchers.back().get());
+		}
+
+		uint32_t takeDirty() noexcept { return dirty.exchange(0, std::memory_order_acquire); }
+		void markAllDirty() noexcept { dirty.store(~0u, std::memory_order_release); }
+
+		static constexpr bool isSet(uint32_t bits, int bit) { return (bits & (1u << bit)) != 0; }
+
+	private:
+		struct Watcher : juce::AudioProcessorParameter::Listener
+		{
+			Watcher(juce::AudioProcessorParameter& p, std::atomic<uint32_t>& d, uint32_t m)
+				: parameter(p), dirty(d), mask(m) {}
+
+			void parameterValueChanged(int, float) override { dirty.fetch_or(mask, std::memory_order_release); }
+			void parameterGestureChanged(int, bool) override {}
+
+			juce::AudioProcessorParameter& parameter;
+			std::atomic<uint32_t>& dirty;
+			const uint32_t mask;
+		};
+
+		std::atomic<uint32_t> dirty { ~0u };
+		std::vector<std::unique_ptr<Watcher>> watchers;
+};
@@ -15,7 +15,7 @@ SeventySixCompressorAudioProcessorEditor::SeventySixCompressorAudioProcessorEdit
 {
 		// Make sure that before the constructor has finished, you've set the
 		// editor's size to whatever you need it to be.
-		setSize (757, 141);
+		setSize (faceplate.getWidth(), faceplate.getHeight() + analyzerHeight);
 		backgroundImg = juce::ImageCache::getFromMemory(BinaryData::bg_png, BinaryData::bg_pngSize);
 		knobImg = juce::ImageCache::getFromMemory(BinaryData::knob_png, BinaryData::knob_pngSize);
 		knob2Img = juce::ImageCache::getFromMemory(BinaryData::knob2_png, BinaryData::knob2_pngSize);
@@ -94,35 +94,17 @@ SeventySixCompressorAudioProcessorEditor::SeventySixCompressorAudioProcessorEdit
 		releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
 				audioProcessor.apvts, "Release", releaseKnob);
 
+		ratioParam = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Ratio"));
+		allButtonsParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
+		jassert(ratioParam != nullptr && allButtonsParam != nullptr);
+
 		allButtonsButton.onClick = [this] {
-			auto* param = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-			if (param)
-				param->setValueNotifyingHost(param->get() ? 0.0f : 1.0f);
-		};
-		ratio4Button.onClick  = [this] {
-			auto* allParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-			if (allParam && allParam->get())
-				allParam->setValueNotifyingHost(0.0f);
-			audioProcessor.apvts.getParameter("Ratio")->setValueNotifyingHost(0.0f);
-		};
-		ratio8Button.onClick  = [this] {
-			auto* allParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-			if (allParam && allParam->get())
-				allParam->setValueNotifyingHost(0.0f);
-			audioProcessor.apvts.getParameter("Ratio")->setValueNotifyingHost(1.0f / 3.0f);
-		};
-		ratio12Button.onClick = [this] {
-			auto* allParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-			if (allParam && allParam->get())
-				allParam->setValueNotifyingHost(0.0f);
-			audioProcessor.apvts.getParameter("Ratio")->setValueNotifyingHost(2.0f / 3.0f);
-		};
-		ratio20Button.onClick = [this] {
-			auto* allParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-			if (allParam && allParam->get())
-				allParam->setValueNotifyingHost(0.0f);
-			audioProcessor.apvts.getParameter("Ratio")->setValueNotifyingHost(1.0f);
+			allButtonsParam->setValueNotifyingHost(allButtonsParam->get() ? 0.0f : 1.0f);
 		};
+		ratio4Button.onClick  = [this] { selectRatio(0); };
+		ratio8Button.onClick  = [this] { selectRatio(1); };
+		ratio12Button.onClick = [this] { selectRatio(2); };
+		ratio20Button.onClick = [this] { selectRatio(3); };
 
 		grButton.setImages(false, true, true, buttonImg, 1.0f, juce::Colours::transparentBlack,
 				buttonImg, 1.0f, juce::Colours::transparentBlack,
@@ -143,6 +125,7 @@ SeventySixCompressorAudioProcessorEditor::SeventySixCompressorAudioProcessorEdit
 				buttonImg, 1.0f, juce::Colours::transparentBlack,
 				buttonSelectedImg, 1.0f, juce::Colours::transparentBlack);
 		addAndMakeVisible(grOffButton);
+		addAndMakeVisible(spectrumDisplay);
 
 		grButton.onClick  = [this] { meterMode = GR; };
 		gr4Button.onClick  = [this] { meterMode = PLUS4; };
@@ -153,8 +136,7 @@ SeventySixCompressorAudioProcessorEditor::SeventySixCompressorAudioProcessorEdit
 		gr4Button.setRadioGroupId(2);
 		gr8Button.setRadioGroupId(2);
 		grOffButton.setRadioGroupId(2);
-		startTimerHz(30);
-		timerCallback();
+		syncButtons();
 }
 
 SeventySixCompressorAudioProcessorEditor::~SeventySixCompressorAudioProcessorEditor()
@@ -164,20 +146,18 @@ SeventySixCompressorAudioProcessorEditor::~SeventySixCompressorAudioProcessorEdi
 //==============================================================================
 void SeventySixCompressorAudioProcessorEditor::paint (juce::Graphics& g)
 {
-		g.drawImage(backgroundImg, getLocalBounds().toFloat());
+		const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		if (scale != backgroundLayerScale)
+		{
+			backgroundLayer = backgroundImg.rescaled(juce::roundToInt(faceplate.getWidth() * scale), juce::roundToInt(faceplate.getHeight() * scale),
+				juce::Graphics::highResamplingQuality);
+			backgroundLayerScale = scale;
+		}
+		g.drawImage(backgroundLayer, faceplate.toFloat());
 
 		float minDb = -20.0f;
 		float maxDb = 3.0f;
-		float meterValue = 0.0f;
-		if (meterMode != OFF)
-		{
-			meterValue = audioProcessor.getGainReductionDb();
-			if (meterMode == PLUS4)
-				meterValue += 4.0f;
-			else if (meterMode == PLUS8)
-				meterValue += 8.0f;
-			meterValue = juce::jlimit(minDb, maxDb, meterValue);
-		}
+		float meterValue = shownMeterValue;
 		float norm = (meterValue - minDb) / (maxDb - minDb);
 		juce::Point<float> center(565, 85);
 		float radius = 40.0f;
@@ -195,6 +175,8 @@ void SeventySixCompressorAudioProcessorEditor::paint (juce::Graphics& g)
 
 void SeventySixCompressorAudioProcessorEditor::resized()
 {
+	backgroundLayerScale = 0.0f;
+
 	inputKnob.setBounds(80, 40, 60, 60);
 	outputKnob.setBounds(226, 40, 60, 60);
 	attackKnob.setBounds(363, 25, 30, 30);
@@ -211,19 +193,29 @@ void SeventySixCompressorAudioProcessorEditor::resized()
 	gr8Button.setBounds(660, 67, 15, 22);
 	grOffButton.setBounds(660, 89, 15, 22);
 
+	spectrumDisplay.setBounds(faceplate.getX(), faceplate.getBottom(), faceplate.getWidth(), analyzerHeight);
+
 		// This is generally where you'll want to lay out the positions of any
 		// subcomponents in your editor..
 }
 
-void SeventySixCompressorAudioProcessorEditor::timerCallback()
+void SeventySixCompressorAudioProcessorEditor::selectRatio(int index)
 {
-	auto* ratioParam = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.apvts.getParameter("Ratio"));
-	auto* allButtonsParam = dynamic_cast<juce::AudioParameterBool*>(audioProcessor.apvts.getParameter("All Buttons"));
-	if (!ratioParam || !allButtonsParam)
-		return;
+	if (allButtonsParam->get())
+		allButtonsParam->setValueNotifyingHost(0.0f);
+	ratioParam->setValueNotifyingHost(ratioParam->convertTo0to1(static_cast<float>(index)));
+}
 
+// Toggle states only change when the parameters or the meter mode do
+void SeventySixCompressorAudioProcessorEditor::syncButtons()
+{
 	bool allButtonsOn = allButtonsParam->get();
 	int idx = ratioParam->getIndex();
+	if (allButtonsOn == shownAllButtons && idx == shownRatioIndex && meterMode == shownMeterMode)
+		return;
+	shownAllButtons = allButtonsOn;
+	shownRatioIndex = idx;
+	shownMeterMode = meterMode;
 
 	allButtonsButton.setToggleState(allButtonsOn, juce::dontSendNotification);
 	if (allButtonsOn)
@@ -244,6 +236,38 @@ void SeventySixCompressorAudioProcessorEditor::timerCallback()
 	gr8Button.setToggleState(meterMode == PLUS8, juce::dontSendNotification);
 	gr4Button.setToggleState(meterMode == PLUS4, juce::dontSendNotification);
 	grOffButton.setToggleState(meterMode == OFF, juce::dontSendNotification);
+}
 
-	repaint();
+float SeventySixCompressorAudioProcessorEditor::getMeterValue() const
+{
+	if (meterMode == OFF)
+		return 0.0f;
+	float meterValue = meterDb;
+	if (meterMode == PLUS4)
+		meterValue += 4.0f;
+	else if (meterMode == PLUS8)
+		meterValue += 8.0f;
+	return juce::jlimit(-20.0f, 3.0f, meterValue);
+}
+
+void SeventySixCompressorAudioProcessorEditor::onVBlank()
+{
+	syncButtons();
+	spectrumDisplay.update();
+
+	// Every block since the last frame moves the needle, not just the latest
+	audioProcessor.getMeterFifo().popAll([this](const MeterFrame& frame) {
+		float minGain = 1.0f;
+		for (int ch = 0; ch < frame.numChannels; ++ch)
+			minGain = juce::jmin(minGain, frame.minGain[static_cast<size_t>(ch)]);
+		const float coeff = 1.0f - std::exp(-frame.seconds / vuTimeConstant);
+		meterDb += coeff * (juce::Decibels::gainToDecibels(minGain, -60.0f) - meterDb);
+	});
+
+	// The readout shows two decimals; below that nothing visible changes
+	const float meterValue = getMeterValue();
+	if (std::abs(meterValue - shownMeterValue) < 0.005f)
+		return;
+	shownMeterValue = meterValue;
+	repaint(meterArea);
 }
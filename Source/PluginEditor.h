@@ -11,6 +11,7 @@
 #include <memory>
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumDisplay.hpp"
 
 class KnobLookAndFeel : public juce::LookAndFeel_V4
 {
@@ -35,7 +36,7 @@ class KnobLookAndFeel : public juce::LookAndFeel_V4
 //==============================================================================
 /**
 */
-class SeventySixCompressorAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::Timer
+class SeventySixCompressorAudioProcessorEditor  : public juce::AudioProcessorEditor
 {
 public:
     SeventySixCompressorAudioProcessorEditor (SeventySixCompressorAudioProcessor&);
@@ -47,12 +48,34 @@ public:
 
 private:
     SeventySixCompressorAudioProcessor& audioProcessor;
-    void timerCallback() override;
+    void onVBlank();
+    void syncButtons();
+    float getMeterValue() const;
+    void selectRatio(int index);
+
+    juce::AudioParameterChoice* ratioParam { nullptr };
+    juce::AudioParameterBool* allButtonsParam { nullptr };
+    int shownRatioIndex = -1;
+    bool shownAllButtons = false;
 
     enum MeterMode { GR, PLUS4, PLUS8, OFF };
     MeterMode meterMode = GR;
+    MeterMode shownMeterMode = OFF;
+    // Needle position in dB of GR, with VU ballistics (99% of a step in 300 ms)
+    static constexpr float vuTimeConstant = 0.065f;
+    float meterDb = 0.0f;
+    // What paint() draws; the meter area is only invalidated when this moves
+    float shownMeterValue = 0.0f;
+    const juce::Rectangle<int> meterArea { 520, 40, 90, 90 };
 
     juce::Image backgroundImg;
+    // backgroundImg pre-scaled to the editor's physical pixel size, so a
+    // dirty-region repaint is a clipped blit
+    juce::Image backgroundLayer;
+    float backgroundLayerScale = 0.0f;
+    // The 1176 faceplate, with the analyzer strip below it
+    const juce::Rectangle<int> faceplate { 0, 0, 757, 141 };
+    static constexpr int analyzerHeight = 100;
     juce::Image knobImg;
     juce::Image knob2Img;
     juce::Image buttonImg;
@@ -68,5 +91,10 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> releaseAttachment;
 
+    SpectrumDisplay spectrumDisplay { audioProcessor.getAnalyzer() };
+
+    // Last member: detached before anything onVBlank() touches is destroyed
+    juce::VBlankAttachment vBlankAttachment { this, [this] { onVBlank(); } };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeventySixCompressorAudioProcessorEditor)
 };
@@ -26,40 +26,75 @@ SeventySixCompressorAudioProcessor::SeventySixCompressorAudioProcessor()
     using namespace Params;
     const auto& params = GetParams();
 
-    auto floatHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    auto floatHelper = [&apvts = this->apvts](auto& param, const juce::String& paramId)
     {
-      param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(params.at(paramName)));
+      param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(paramId));
       jassert(param != nullptr);
     };
 
-    floatHelper(compressor.attack, Names::Attack);
-    floatHelper(compressor.release, Names::Release);
-
-    auto choiceHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    auto choiceHelper = [&apvts = this->apvts](auto& param, const juce::String& paramId)
     {
-        DBG("Trying to get parameter: " << params.at(paramName));
-        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(params.at(paramName)));
-        DBG("Result: " << ((param == nullptr) ? "nullptr" : "not null!"));
+        param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(paramId));
         jassert(param != nullptr);
     };
 
-    choiceHelper(compressor.ratio, Names::Ratio);
-
-    auto boolHelper = [&apvts = this->apvts, &params](auto& param, const auto& paramName)
+    auto boolHelper = [&apvts = this->apvts](auto& param, const juce::String& paramId)
     {
-        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(params.at(paramName)));
+        param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(paramId));
         jassert(param != nullptr);
     };
 
-    boolHelper(compressor.bypass, Names::Bypass);
-    boolHelper(compressor.allButtons, Names::All_Buttons);
-
-    floatHelper(compressor.inputGain, Names::Input_Gain);
-    floatHelper(compressor.outputGain, Names::Output_Gain);
+    for (int band = 0; band < MaxBands; ++band)
+    {
+        auto& comp = compressors[static_cast<size_t>(band)];
+        floatHelper(comp.attack, BandParamId(Names::Attack, band));
+        floatHelper(comp.release, BandParamId(Names::Release, band));
+        choiceHelper(comp.ratio, BandParamId(Names::Ratio, band));
+        boolHelper(comp.allButtons, BandParamId(Names::All_Buttons, band));
+        floatHelper(comp.inputGain, BandParamId(Names::Input_Gain, band));
+        floatHelper(comp.outputGain, BandParamId(Names::Output_Gain, band));
+
+        // One bypass for the whole plugin
+        boolHelper(comp.bypass, params.at(Names::Bypass));
+        boolHelper(comp.warmBypass, params.at(Names::Warm_Bypass));
+        choiceHelper(comp.stereoLink, params.at(Names::Stereo_Link));
+        floatHelper(comp.mix, params.at(Names::Mix));
+        comp.watchParameters();
+    }
+
+    choiceHelper(oversampling, params.at(Names::Oversampling));
+    choiceHelper(oversamplingFilter, params.at(Names::Oversampling_Filter));
+    boolHelper(splitRateDetector, params.at(Names::Split_Rate_Detector));
+    choiceHelper(bands, params.at(Names::Bands));
+    floatHelper(crossovers[0], params.at(Names::Crossover_1));
+    floatHelper(crossovers[1], params.at(Names::Crossover_2));
+    floatHelper(crossovers[2], params.at(Names::Crossover_3));
+    choiceHelper(lookahead, params.at(Names::Lookahead));
+    choiceHelper(linkGroups, params.at(Names::Link_Groups));
+    for (size_t ch = 0; ch < channelLinkGroups.size(); ++ch)
+        choiceHelper(channelLinkGroups[ch], ChannelLinkGroupId(static_cast<int>(ch)));
+    apvts.addParameterListener(params.at(Names::Oversampling), this);
+    apvts.addParameterListener(params.at(Names::Oversampling_Filter), this);
+    apvts.addParameterListener(params.at(Names::Split_Rate_Detector), this);
+    apvts.addParameterListener(params.at(Names::Bands), this);
+    apvts.addParameterListener(params.at(Names::Lookahead), this);
+    apvts.addParameterListener(params.at(Names::Link_Groups), this);
+    for (int ch = 0; ch < Compressor1176::maxChannels; ++ch)
+        apvts.addParameterListener(ChannelLinkGroupId(ch), this);
 }
 
 SeventySixCompressorAudioProcessor::~SeventySixCompressorAudioProcessor()
 {
+    const auto& params = Params::GetParams();
+    apvts.removeParameterListener(params.at(Params::Names::Oversampling), this);
+    apvts.removeParameterListener(params.at(Params::Names::Oversampling_Filter), this);
+    apvts.removeParameterListener(params.at(Params::Names::Split_Rate_Detector), this);
+    apvts.removeParameterListener(params.at(Params::Names::Bands), this);
+    apvts.removeParameterListener(params.at(Params::Names::Lookahead), this);
+    apvts.removeParameterListener(params.at(Params::Names::Link_Groups), this);
+    for (int ch = 0; ch < Compressor1176::maxChannels; ++ch)
+        apvts.removeParameterListener(Params::ChannelLinkGroupId(ch), this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -97,7 +132,15 @@ bool SeventySixCompressorAudioProcessor::isMidiEffect() const
 
 double SeventySixCompressorAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    if (preparedBands == 1)
+        return compressor.getTailLengthSeconds();
+
+    double tail = 0.0;
+    for (int band = 0; band < preparedBands; ++band)
+        tail = juce::jmax(tail, compressors[static_cast<size_t>(band)].getTailLengthSeconds());
+    const int splitLatency = preparedDoublePrecision ? doubleSplit.splitter.getLatencySamples()
+                                                     : floatSplit.splitter.getLatencySamples();
+    return tail + splitLatency / preparedSpec.sampleRate;
 }
 
 int SeventySixCompressorAudioProcessor::getNumPrograms()
@@ -134,9 +177,124 @@ void SeventySixCompressorAudioProcessor::prepareToPlay (double sampleRate, int s
     spec.numChannels = getTotalNumOutputChannels();
     spec.sampleRate = sampleRate;
 
-    for (auto &comp : compressors)
-        comp.prepare(spec);
+    preparedSpec = spec;
+    prepareCompressors();
+    analyzer.prepare(sampleRate, getTotalNumOutputChannels());
+}
+
+void SeventySixCompressorAudioProcessor::prepareCompressors()
+{
+    preparedOversampling = oversampling->getIndex();
+    preparedOversamplingFilter = oversamplingFilter->getIndex();
+    preparedSplitRate = splitRateDetector->get();
+    preparedBands = bands->getIndex() + 1;
+    preparedLookaheadSamples = getLookaheadSamples();
+    preparedDoublePrecision = isUsingDoublePrecision();
+    preparedLinkGroups = getLinkGroups();
+    for (auto& band : compressors)
+        band.setLinkGroups(preparedLinkGroups);
+
+    const float lookaheadMs = static_cast<float>(preparedLookaheadSamples * 1000.0 / preparedSpec.sampleRate);
+
+    if (preparedBands == 1)
+    {
+        compressor.setOversampling(preparedOversampling, preparedOversamplingFilter == 1, preparedSplitRate);
+        compressor.setLookahead(lookaheadMs);
+        compressor.prepare(preparedSpec, preparedDoublePrecision);
+        setLatencySamples(compressor.getLatencySamples());
+        return;
+    }
+
+    // The bands run on the splitter's oversampled signal and do not
+    // oversample again. There is no host-rate band signal for the
+    // split-rate detector, so it only applies to a single band.
+    auto prepareSplit = [&](auto& split)
+    {
+        split.splitter.setOversampling(preparedOversampling, preparedOversamplingFilter == 1);
+        split.splitter.setNumBands(preparedBands);
+        for (size_t k = 0; k < crossovers.size(); ++k)
+            split.splitter.setCrossoverFrequency(static_cast<int>(k), crossovers[k]->get());
+        split.splitter.prepare(preparedSpec);
+        for (int band = 0; band < preparedBands; ++band)
+        {
+            auto& comp = compressors[static_cast<size_t>(band)];
+            comp.setOversampling(0, false, false);
+            comp.setLookahead(lookaheadMs);
+            comp.prepareSplit(split.splitter.getBandSpec(), preparedDoublePrecision);
+        }
+
+        const int latency = split.splitter.getLatencySamples() + preparedLookaheadSamples;
+        const int numChannels = static_cast<int>(preparedSpec.numChannels);
+        split.dryDelay.prepare(numChannels, latency);
+        split.dryBuffer.setSize(numChannels, static_cast<int>(preparedSpec.maximumBlockSize));
+        split.mix.setMix(compressor.mix->get() * 0.01f);
+        split.mix.prepare(preparedSpec.sampleRate, static_cast<int>(preparedSpec.maximumBlockSize));
+        setLatencySamples(latency);
+    };
+    if (preparedDoublePrecision)
+        prepareSplit(doubleSplit);
+    else
+        prepareSplit(floatSplit);
+    splitBypassFade.setBypassed(compressor.bypass->get());
+    splitBypassFade.prepare(preparedSpec.sampleRate);
+    splitCold = false;
+}
+
+// For the main bus as it is laid out now
+std::vector<int> SeventySixCompressorAudioProcessor::getLinkGroups() const
+{
+    const auto layout = getChannelLayoutOfBus (false, 0);
+    switch (linkGroups->getIndex())
+    {
+        case 1:
+            return LinkGroups::fromSpeakerPositions (layout);
+        case 2:
+        {
+            std::vector<int> groups;
+            for (int ch = 0; ch < juce::jmin (layout.size(), Compressor1176::maxChannels); ++ch)
+                groups.push_back (channelLinkGroups[static_cast<size_t>(ch)]->getIndex());
+            return groups;
+        }
+        default:
+            return LinkGroups::allLinked (layout.size());
+    }
+}
+
+// Whole host samples, so bands running at the oversampled rate also delay by
+// whole host samples and the reported latency stays exact
+int SeventySixCompressorAudioProcessor::getLookaheadSamples() const
+{
+    const float lookaheadMs = Params::LookaheadChoices[static_cast<size_t>(lookahead->getIndex())];
+    return juce::jmin(juce::roundToInt(lookaheadMs * 0.001 * preparedSpec.sampleRate),
+                      static_cast<int>(Compressor1176::maxLookaheadMs * 0.001 * preparedSpec.sampleRate));
+}
+
+// May be called from the audio thread (host automation), so only flag the
+// rebuild here and do the allocation on the message thread.
+void SeventySixCompressorAudioProcessor::parameterChanged (const juce::String&, float)
+{
+    triggerAsyncUpdate();
+}
 
+void SeventySixCompressorAudioProcessor::handleAsyncUpdate()
+{
+    if (preparedSpec.sampleRate <= 0
+     || (oversampling->getIndex() == preparedOversampling
+      && oversamplingFilter->getIndex() == preparedOversamplingFilter
+      && splitRateDetector->get() == preparedSplitRate
+      && bands->getIndex() + 1 == preparedBands
+      && getLookaheadSamples() == preparedLookaheadSamples
+      && isUsingDoublePrecision() == preparedDoublePrecision
+      && getLinkGroups() == preparedLinkGroups))
+        return;
+
+    // suspendProcessing() takes the callback lock only to set the flag, which
+    // waits out a block already running; while the flag is set the wrapper
+    // outputs silence instead of calling processBlock, so no block runs
+    // against a half-built oversampler
+    suspendProcessing (true);
+    prepareCompressors();
+    suspendProcessing (false);
 }
 
 void SeventySixCompressorAudioProcessor::releaseResources()
@@ -152,12 +310,11 @@ bool SeventySixCompressorAudioProcessor::isBusesLayoutSupported (const BusesLayo
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout, named or discrete, up to Compressor1176::maxChannels: one
+    // instance (and one oversampler) covers a whole surround or immersive
+    // stem, with Link Groups deciding which channels share a detector
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > Compressor1176::maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -175,6 +332,11 @@ void SeventySixCompressorAudioProcessor::updateState()
 {
     for (auto& compressor : compressors)
         compressor.updateCompressorSettings();
+    for (size_t k = 0; k < crossovers.size(); ++k)
+    {
+        floatSplit.splitter.setCrossoverFrequency(static_cast<int>(k), crossovers[k]->get());
+        doubleSplit.splitter.setCrossoverFrequency(static_cast<int>(k), crossovers[k]->get());
+    }
 }
 
 void SeventySixCompressorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
@@ -185,8 +347,113 @@ void SeventySixCompressorAudioProcessor::processBlock (juce::AudioBuffer<float>&
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
+    processCompressors(buffer, false);
+}
+
+void SeventySixCompressorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    juce::ScopedNoDenormals noDenormals;
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+    processCompressors(buffer, false);
+}
+
+// Hosts that bypass without our parameter land here; same delayed, crossfaded
+// path, so the reported latency holds and the detector stays warm.
+void SeventySixCompressorAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    juce::ScopedNoDenormals noDenormals;
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+    processCompressors(buffer, true);
+}
+
+void SeventySixCompressorAudioProcessor::processBlockBypassed (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    juce::ScopedNoDenormals noDenormals;
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+    processCompressors(buffer, true);
+}
+
+// Shared by both precisions
+template <typename SampleType>
+void SeventySixCompressorAudioProcessor::processCompressors (juce::AudioBuffer<SampleType>& buffer, bool hostBypassed)
+{
     updateState();
-    compressor.process(buffer);
+
+    analyzer.pushPre(buffer);
+    if (preparedBands == 1)
+        compressor.process(buffer, hostBypassed);
+    else
+        processBands(buffer, hostBypassed);
+    analyzer.pushPost(buffer);
+
+    MeterFrame frame;
+    frame.numChannels = juce::jmin(buffer.getNumChannels(), MeterFrame::maxChannels);
+    frame.seconds = static_cast<float>(buffer.getNumSamples() / getSampleRate());
+    for (int ch = 0; ch < frame.numChannels; ++ch)
+        frame.minGain[ch] = getBlockMinGain(ch);
+    meterFifo.push(frame);
+}
+
+// CompressorBand::process() around the whole split: the same delayed dry
+// path and crossfade. Warm bypass keeps the split and each band's sidechain
+// running, so every band's GR is current when it fades back in.
+template <typename SampleType>
+void SeventySixCompressorAudioProcessor::processBands (juce::AudioBuffer<SampleType>& buffer, bool hostBypassed)
+{
+    auto& split = getSplit<SampleType>();
+    const int numSamples = buffer.getNumSamples();
+    splitBypassFade.setBypassed(hostBypassed || compressor.bypass->get());
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        split.dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+    split.dryDelay.process(split.dryBuffer, numSamples);
+
+    if (splitBypassFade.isFullyBypassed())
+    {
+        if (compressor.warmBypass->get())
+            split.splitter.process(buffer, [this](int band, juce::AudioBuffer<SampleType>& bandBuffer)
+                { compressors[static_cast<size_t>(band)].processSplitSidechain(bandBuffer); });
+        else
+            splitCold = true;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.copyFrom(ch, 0, split.dryBuffer, ch, 0, numSamples);
+        return;
+    }
+
+    if (splitCold)
+    {
+        split.splitter.reset();
+        for (int band = 0; band < preparedBands; ++band)
+            compressors[static_cast<size_t>(band)].resetSplit();
+        splitCold = false;
+    }
+    split.splitter.process(buffer, [this](int band, juce::AudioBuffer<SampleType>& bandBuffer)
+        { compressors[static_cast<size_t>(band)].processSplit(bandBuffer); });
+    split.mix.setMix(compressor.mix->get() * 0.01f);
+    split.mix.process(buffer, split.dryBuffer, numSamples);
+    if (splitBypassFade.isFading())
+        splitBypassFade.process(buffer, split.dryBuffer, numSamples);
+}
+
+// The meter shows the band compressing hardest
+float SeventySixCompressorAudioProcessor::getBlockMinGain (int channel) const
+{
+    if (preparedBands == 1)
+        return compressor.getBlockMinGain(channel);
+    if (splitBypassFade.isFullyBypassed())
+        return 1.0f;
+
+    float gain = 1.0f;
+    for (int band = 0; band < preparedBands; ++band)
+        gain = juce::jmin(gain, compressors[static_cast<size_t>(band)].getSplitMinGain(channel));
+    return gain;
+}
+
+juce::AudioProcessorParameter* SeventySixCompressorAudioProcessor::getBypassParameter() const
+{
+    return compressor.bypass;
 }
 
 //==============================================================================
@@ -216,7 +483,11 @@ void SeventySixCompressorAudioProcessor::setStateInformation (const void* data,
     // whose contents will have been created by the getStateInformation() call.
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if (tree.isValid())
+    {
         apvts.replaceState(tree);
+        for (auto& band : compressors)
+            band.markSettingsDirty();
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SeventySixCompressorAudioProcessor::createParameterLayout()
@@ -228,20 +499,76 @@ juce::AudioProcessorValueTreeState::ParameterLayout SeventySixCompressorAudioPro
     const auto& params = GetParams();
 
     auto gainRange = NormalisableRange<float>(-40.f, 40.f, 0.5f, 1);
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Input_Gain), params.at(Names::Input_Gain), gainRange, 0.f));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Output_Gain), params.at(Names::Output_Gain), gainRange, 0.f));
-
     auto attackReleaseRange = NormalisableRange<float>(1, 7, 1, 1);
-    layout.add(std::make_unique<AudioParameterFloat>("Attack", "Attack", attackReleaseRange, 4));
-    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Release), params.at(Names::Release), attackReleaseRange, 4));
-
-    auto choices = std::vector<double>{ 4, 8, 12, 20 };
     juce::StringArray sa;
-    for (auto choice : choices)
+    for (auto choice : RatioChoices)
         sa.add(juce::String(choice, 1));
-    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Ratio), params.at(Names::Ratio), sa, 0));
+
+    // The 1176 controls, once per band
+    auto addBandParameters = [&](int band)
+    {
+        const auto inputGainId = BandParamId(Names::Input_Gain, band);
+        const auto outputGainId = BandParamId(Names::Output_Gain, band);
+        const auto attackId = BandParamId(Names::Attack, band);
+        const auto releaseId = BandParamId(Names::Release, band);
+        const auto ratioId = BandParamId(Names::Ratio, band);
+        const auto allButtonsId = BandParamId(Names::All_Buttons, band);
+        layout.add(std::make_unique<AudioParameterFloat>(inputGainId, inputGainId, gainRange, 0.f));
+        layout.add(std::make_unique<AudioParameterFloat>(outputGainId, outputGainId, gainRange, 0.f));
+        layout.add(std::make_unique<AudioParameterFloat>(attackId, attackId, attackReleaseRange, 4));
+        layout.add(std::make_unique<AudioParameterFloat>(releaseId, releaseId, attackReleaseRange, 4));
+        layout.add(std::make_unique<AudioParameterChoice>(ratioId, ratioId, sa, 0));
+        layout.add(std::make_unique<AudioParameterBool>(allButtonsId, allButtonsId, false));
+    };
+
+    addBandParameters(0);
     layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Bypass), params.at(Names::Bypass), false));
-    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::All_Buttons), params.at(Names::All_Buttons), false));
+    // Keeps the detector running while bypassed, so un-bypassing picks up the current GR
+    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Warm_Bypass), params.at(Names::Warm_Bypass), true));
+
+    // 1x/2x for big sessions, linear phase for masters; 4x IIR is the original sound
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Oversampling), params.at(Names::Oversampling),
+        StringArray { "1x", "2x", "4x", "8x" }, 2));
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Oversampling_Filter), params.at(Names::Oversampling_Filter),
+        StringArray { "IIR", "Linear Phase" }, 0));
+    // Detector and GR ballistics at the host rate; only the FET stages are oversampled
+    layout.add(std::make_unique<AudioParameterBool>(params.at(Names::Split_Rate_Detector), params.at(Names::Split_Rate_Detector), false));
+
+    // 2-4 bands split by Linkwitz-Riley crossovers, numbered from the bottom
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Bands), params.at(Names::Bands),
+        StringArray { "1", "2", "3", "4" }, 0));
+    auto crossoverRange = NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f);
+    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Crossover_1), params.at(Names::Crossover_1), crossoverRange, 120.f));
+    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Crossover_2), params.at(Names::Crossover_2), crossoverRange, 1000.f));
+    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Crossover_3), params.at(Names::Crossover_3), crossoverRange, 5000.f));
+    for (int band = 1; band < MaxBands; ++band)
+        addBandParameters(band);
+
+    // One detector per link group, driven by its loudest channel or by the
+    // mean of its channels; dual mono is the original behaviour
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Stereo_Link), params.at(Names::Stereo_Link),
+        StringArray { "Dual Mono", "Max", "Sum" }, 0));
+    // Delays the audio so the detector sees peaks before they arrive; adds
+    // to the reported latency. A change re-primes the engine on the message
+    // thread (a short dropout and a latency jump), so it is not meant to be
+    // automated.
+    StringArray lookaheadNames;
+    for (auto choice : LookaheadChoices)
+        lookaheadNames.add(String(choice, 1) + " ms");
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Lookahead), params.at(Names::Lookahead),
+        lookaheadNames, 0));
+    // Parallel compression against the latency-aligned dry signal, in percent wet
+    layout.add(std::make_unique<AudioParameterFloat>(params.at(Names::Mix), params.at(Names::Mix),
+        NormalisableRange<float>(0.f, 100.f, 0.1f), 100.f));
+    // Which channels Stereo Link links: all of them, fronts/surrounds/heights
+    // with the LFE on its own, or the per-channel groups below
+    layout.add(std::make_unique<AudioParameterChoice>(params.at(Names::Link_Groups), params.at(Names::Link_Groups),
+        StringArray { "All Channels", "By Position", "Custom" }, 0));
+    StringArray groupNames { "Own" };
+    for (int group = 1; group <= MaxLinkGroups; ++group)
+        groupNames.add(String(group));
+    for (int ch = 0; ch < Compressor1176::maxChannels; ++ch)
+        layout.add(std::make_unique<AudioParameterChoice>(ChannelLinkGroupId(ch), ChannelLinkGroupId(ch), groupNames, 1));
     return layout;
 }
 
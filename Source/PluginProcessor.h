@@ -2,15 +2,22 @@
 
 #include <JuceHeader.h>
 #include "Compressor1176.hpp"
+#include "DryDelayLine.hpp"
+#include "BypassCrossfade.hpp"
+#include "ParallelMix.hpp"
+#include "ParameterDirtyFlags.hpp"
+#include "MeterFifo.hpp"
+#include "SpectrumAnalyzer.hpp"
+#include "BandSplitter.hpp"
+#include "LinkGroups.hpp"
 
 /*
-GUI:
-1) controls for attack, release, ratio, i/o gain
-2) add bypass
-3) spectrum analyzer
-4) data structs for spectrum analyzer
-5) fifo usage in pluginProcessor processBlcok
-6)
+GUI (these are host parameters only for now):
+1) bypass and warm bypass
+2) oversampling, oversampling filter, split-rate detector
+3) stereo link, link groups
+4) lookahead and mix
+5) multiband: bands 2-4 and the crossovers
 */
 
 namespace Params
@@ -23,7 +30,19 @@ namespace Params
     Bypass,
     All_Buttons,
     Input_Gain,
-    Output_Gain
+    Output_Gain,
+    Oversampling,
+    Oversampling_Filter,
+    Split_Rate_Detector,
+    Warm_Bypass,
+    Bands,
+    Crossover_1,
+    Crossover_2,
+    Crossover_3,
+    Stereo_Link,
+    Lookahead,
+    Mix,
+    Link_Groups
   };
 
   inline const std::map<Names, juce::String>& GetParams()
@@ -35,16 +54,125 @@ namespace Params
       {Bypass, "Bypass"},
       {All_Buttons, "All Buttons"},
       {Input_Gain, "Input Gain"},
-      {Output_Gain, "Output Gain"}
+      {Output_Gain, "Output Gain"},
+      {Oversampling, "Oversampling"},
+      {Oversampling_Filter, "Oversampling Filter"},
+      {Split_Rate_Detector, "Split-Rate Detector"},
+      {Warm_Bypass, "Warm Bypass"},
+      {Bands, "Bands"},
+      {Crossover_1, "Crossover 1"},
+      {Crossover_2, "Crossover 2"},
+      {Crossover_3, "Crossover 3"},
+      {Stereo_Link, "Stereo Link"},
+      {Lookahead, "Lookahead"},
+      {Mix, "Mix"},
+      {Link_Groups, "Link Groups"}
     };
 
     return params;
   }
+
+  // Ratio choice index -> ratio, so the audio thread never parses the choice name
+  inline constexpr std::array<float, 4> RatioChoices { 4.0f, 8.0f, 12.0f, 20.0f };
+
+  // Lookahead choice index -> ms. Stepped rather than continuous, since
+  // every change re-primes the engine.
+  inline constexpr std::array<float, 5> LookaheadChoices { 0.0f, 0.5f, 1.0f, 2.0f, 5.0f };
+
+  inline constexpr int MaxBands = BandSplitter<float>::maxBands;
+
+  // Link Groups set to Custom: a group per channel, 0 ("Own") for none
+  inline constexpr int MaxLinkGroups = 8;
+  inline juce::String ChannelLinkGroupId(int channel) { return "Link Group Ch " + juce::String(channel + 1); }
+
+  // Band 1 keeps the original IDs, so single-band sessions load unchanged;
+  // the others append the band number ("Attack 2")
+  inline juce::String BandParamId(Names name, int band)
+  {
+    const auto& id = GetParams().at(name);
+    return band == 0 ? id : id + " " + juce::String(band + 1);
+  }
 };
 
 struct CompressorBand {
   private:
-    Compressor1176 compressor;
+    // Everything that carries audio, once per sample type. Only the chain
+    // matching the host's processing precision is prepared and run.
+    template <typename SampleType>
+    struct Chain
+    {
+      BasicCompressor1176<SampleType> compressor;
+      // Bypass output: the input delayed by the oversampler latency, so the
+      // host's delay compensation holds either way. The mix blends with the
+      // same dry signal.
+      DryDelayLine<SampleType> dryDelay;
+      juce::AudioBuffer<SampleType> dryBuffer;
+      ParallelMix<SampleType> parallelMix;
+    };
+    Chain<float> floatChain;
+    Chain<double> doubleChain;
+    bool doublePrecision = false;
+    BypassCrossfade bypassFade;
+    bool detectorCold = false;
+
+    template <typename SampleType>
+    Chain<SampleType>& getChain()
+    {
+      if constexpr (std::is_same_v<SampleType, double>)
+        return doubleChain;
+      else
+        return floatChain;
+    }
+
+    // Settings go to both engines, so nothing is lost when the host
+    // switches precision; only the prepared one runs
+    template <typename Function>
+    void forEachCompressor(Function&& fn)
+    {
+      fn(floatChain.compressor);
+      fn(doubleChain.compressor);
+    }
+
+    template <typename Function>
+    auto withActiveCompressor(Function&& fn) const
+    {
+      return doublePrecision ? fn(doubleChain.compressor) : fn(floatChain.compressor);
+    }
+
+    // Last values handed to the compressor; only parameters whose dirty bit
+    // is set get re-read, and only their setters run
+    struct Settings
+    {
+      float attack = 0.0f;
+      float release = 0.0f;
+      float ratio = 4.0f;
+      float inputGain = 0.0f;
+      float outputGain = 0.0f;
+      bool allButtons = false;
+      int stereoLink = 0;
+    };
+    enum DirtyBit { AttackBit, ReleaseBit, RatioBit, InputGainBit, OutputGainBit, AllButtonsBit, StereoLinkBit };
+    Settings settings;
+    ParameterDirtyFlags dirtyFlags;
+
+    template <typename Compressor>
+    void applySettings(Compressor& compressor, uint32_t changed) const
+    {
+      if (ParameterDirtyFlags::isSet(changed, AttackBit))
+        compressor.setAttack(settings.attack);
+      if (ParameterDirtyFlags::isSet(changed, ReleaseBit))
+        compressor.setRelease(settings.release);
+      if (ParameterDirtyFlags::isSet(changed, AllButtonsBit))
+        compressor.setAllButtons(settings.allButtons);
+      if (ParameterDirtyFlags::isSet(changed, RatioBit))
+        compressor.setRatio(settings.ratio);
+      if (ParameterDirtyFlags::isSet(changed, InputGainBit))
+        compressor.setInputGain(settings.inputGain);
+      if (ParameterDirtyFlags::isSet(changed, OutputGainBit))
+        compressor.setOutputGain(settings.outputGain);
+      if (ParameterDirtyFlags::isSet(changed, StereoLinkBit))
+        compressor.setLinkMode(static_cast<Compressor1176Base::LinkMode>(settings.stereoLink));
+    }
   public:
     juce::AudioParameterFloat* attack { nullptr };
     juce::AudioParameterFloat* release { nullptr };
@@ -52,38 +180,154 @@ struct CompressorBand {
     juce::AudioParameterFloat* inputGain { nullptr };
     juce::AudioParameterFloat* outputGain { nullptr };
     juce::AudioParameterBool* bypass { nullptr };
+    juce::AudioParameterBool* warmBypass { nullptr };
     juce::AudioParameterBool* allButtons { nullptr };
+    juce::AudioParameterChoice* stereoLink { nullptr };
+    juce::AudioParameterFloat* mix { nullptr };
 
-    void prepare(const juce::dsp::ProcessSpec& spec)
+    void prepare(const juce::dsp::ProcessSpec& spec, bool useDoublePrecision)
     {
-      compressor.prepare(spec);
+      doublePrecision = useDoublePrecision;
+      auto prepareChain = [&](auto& chain)
+      {
+        chain.compressor.prepare(spec);
+        chain.dryDelay.prepare(static_cast<int>(spec.numChannels), chain.compressor.getLatencySamples());
+        chain.dryBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+        chain.parallelMix.setMix(mix->get() * 0.01f);
+        chain.parallelMix.prepare(spec.sampleRate, static_cast<int>(spec.maximumBlockSize));
+      };
+      if (doublePrecision)
+        prepareChain(doubleChain);
+      else
+        prepareChain(floatChain);
+      bypassFade.setBypassed(bypass->get());
+      bypassFade.prepare(spec.sampleRate);
+      detectorCold = false;
+      dirtyFlags.markAllDirty();
     }
 
+    // Multiband: only the compressor, since the splitter owns the dry path,
+    // mix and bypass of the whole split
+    void prepareSplit(const juce::dsp::ProcessSpec& spec, bool useDoublePrecision)
+    {
+      doublePrecision = useDoublePrecision;
+      if (doublePrecision)
+        doubleChain.compressor.prepare(spec);
+      else
+        floatChain.compressor.prepare(spec);
+      dirtyFlags.markAllDirty();
+    }
+
+    void setOversampling(int stages, bool linearPhase, bool splitRateDetector)
+    {
+      forEachCompressor([&](auto& compressor)
+      {
+        compressor.setOversampling(stages, linearPhase);
+        compressor.setSplitRateDetector(splitRateDetector);
+      });
+    }
+
+    void setLookahead(float lookaheadMs) { forEachCompressor([=](auto& compressor) { compressor.setLookahead(lookaheadMs); }); }
+    void setLinkGroups(const std::vector<int>& groups) { forEachCompressor([&](auto& compressor) { compressor.setLinkGroups(groups); }); }
+
+    int getLatencySamples() const { return withActiveCompressor([](const auto& c) { return c.getLatencySamples(); }); }
+    double getTailLengthSeconds() const { return withActiveCompressor([](const auto& c) { return c.getTailLengthSeconds(); }); }
+
+    // Multiband: this band's share of the split, already oversampled. Bypass
+    // and its dry path wrap the whole split instead of each band.
+    template <typename SampleType>
+    void processSplit(juce::AudioBuffer<SampleType>& band) { getChain<SampleType>().compressor.process(band); }
+    template <typename SampleType>
+    void processSplitSidechain(const juce::AudioBuffer<SampleType>& band) { getChain<SampleType>().compressor.processSidechain(band); }
+    void resetSplit() { forEachCompressor([](auto& compressor) { compressor.reset(); }); }
+    float getSplitMinGain(int channel) const { return withActiveCompressor([=](const auto& c) { return c.getBlockMinGain(channel); }); }
+
+    // Call once the parameter pointers are set
+    void watchParameters()
+    {
+      dirtyFlags.watch(*attack, AttackBit);
+      dirtyFlags.watch(*release, ReleaseBit);
+      dirtyFlags.watch(*ratio, RatioBit);
+      dirtyFlags.watch(*inputGain, InputGainBit);
+      dirtyFlags.watch(*outputGain, OutputGainBit);
+      dirtyFlags.watch(*allButtons, AllButtonsBit);
+      dirtyFlags.watch(*stereoLink, StereoLinkBit);
+    }
+
+    // The next block re-reads every parameter, not just the ones that moved
+    void markSettingsDirty() { dirtyFlags.markAllDirty(); }
+
     void updateCompressorSettings()
     {
-      compressor.setAttack(attack->get());
-      compressor.setRelease(release->get());
-      compressor.setAllButtons(allButtons->get());
-
-      compressor.setRatio(
-          ratio->getCurrentChoiceName().getFloatValue());
-      compressor.setInputGain(inputGain->get());
-      compressor.setOutputGain(outputGain->get());
+      const uint32_t changed = dirtyFlags.takeDirty();
+      if (changed == 0)
+        return;
+
+      if (ParameterDirtyFlags::isSet(changed, AttackBit))
+        settings.attack = attack->get();
+      if (ParameterDirtyFlags::isSet(changed, ReleaseBit))
+        settings.release = release->get();
+      if (ParameterDirtyFlags::isSet(changed, AllButtonsBit))
+        settings.allButtons = allButtons->get();
+      if (ParameterDirtyFlags::isSet(changed, RatioBit))
+        settings.ratio = Params::RatioChoices[static_cast<size_t>(ratio->getIndex())];
+      if (ParameterDirtyFlags::isSet(changed, InputGainBit))
+        settings.inputGain = inputGain->get();
+      if (ParameterDirtyFlags::isSet(changed, OutputGainBit))
+        settings.outputGain = outputGain->get();
+      if (ParameterDirtyFlags::isSet(changed, StereoLinkBit))
+        settings.stereoLink = stereoLink->getIndex();
+      forEachCompressor([&](auto& compressor) { applySettings(compressor, changed); });
     }
 
-    float getGainReductionDb() const { return compressor.getGainReductionDb(); }
+    // The meter rests while fully bypassed
+    float getBlockMinGain(int channel) const { return bypassFade.isFullyBypassed() ? 1.0f : getSplitMinGain(channel); }
 
-    void process(juce::AudioBuffer<float>& buffer)
+    // Bypass fades over 20 ms to the delayed dry signal. While fully
+    // bypassed the detector keeps running (Warm Bypass), so the GR is
+    // current when the compressor fades back in; otherwise it restarts
+    // from rest.
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, bool hostBypassed = false)
     {
-      if (!bypass->get())
-        compressor.process(buffer);
+      auto& chain = getChain<SampleType>();
+      jassert(doublePrecision == (std::is_same_v<SampleType, double>));
+      const int numSamples = buffer.getNumSamples();
+      bypassFade.setBypassed(hostBypassed || bypass->get());
+      for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        chain.dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+      chain.dryDelay.process(chain.dryBuffer, numSamples);
+
+      if (bypassFade.isFullyBypassed())
+      {
+        if (warmBypass->get())
+          chain.compressor.processSidechain(buffer);
+        else
+          detectorCold = true;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+          buffer.copyFrom(ch, 0, chain.dryBuffer, ch, 0, numSamples);
+        return;
+      }
+
+      if (detectorCold)
+      {
+        chain.compressor.reset();
+        detectorCold = false;
+      }
+      chain.compressor.process(buffer);
+      chain.parallelMix.setMix(mix->get() * 0.01f);
+      chain.parallelMix.process(buffer, chain.dryBuffer, numSamples);
+      if (bypassFade.isFading())
+        bypassFade.process(buffer, chain.dryBuffer, numSamples);
     }
 };
 
 //==============================================================================
 /**
 */
-class SeventySixCompressorAudioProcessor  : public juce::AudioProcessor
+class SeventySixCompressorAudioProcessor  : public juce::AudioProcessor,
+                                            private juce::AudioProcessorValueTreeState::Listener,
+                                            private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -99,6 +343,11 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -128,11 +377,72 @@ public:
 
     APVTS apvts;
 
-    float getGainReductionDb() const { return compressor.getGainReductionDb(); }
+    // Filled once per block on the audio thread, drained by the editor
+    MeterFifo& getMeterFifo() { return meterFifo; }
+    SpectrumAnalyzer& getAnalyzer() { return analyzer; }
 private:
-    std::array<CompressorBand, 1> compressors;
+    MeterFifo meterFifo;
+    SpectrumAnalyzer analyzer;
+
+    std::array<CompressorBand, Params::MaxBands> compressors;
+    // Band 1; the only one running in single-band mode. Its bypass is the
+    // plugin's bypass in either mode.
     CompressorBand& compressor = compressors[0];
 
+    // Multiband: one oversampling pass shared by every band, with bypass
+    // crossfaded around the whole split. One split per sample type, as in
+    // CompressorBand.
+    template <typename SampleType>
+    struct SplitChain
+    {
+        BandSplitter<SampleType> splitter;
+        DryDelayLine<SampleType> dryDelay;
+        juce::AudioBuffer<SampleType> dryBuffer;
+        ParallelMix<SampleType> mix;
+    };
+    juce::AudioParameterChoice* bands { nullptr };
+    std::array<juce::AudioParameterFloat*, Params::MaxBands - 1> crossovers {};
+    SplitChain<float> floatSplit;
+    SplitChain<double> doubleSplit;
+    BypassCrossfade splitBypassFade;
+    bool splitCold = false;
+
+    template <typename SampleType>
+    SplitChain<SampleType>& getSplit()
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleSplit;
+        else
+            return floatSplit;
+    }
+
+    // Oversampling is rebuilt on the message thread, never inside processBlock
+    juce::AudioParameterChoice* oversampling { nullptr };
+    juce::AudioParameterChoice* oversamplingFilter { nullptr };
+    juce::AudioParameterBool* splitRateDetector { nullptr };
+    juce::AudioParameterChoice* lookahead { nullptr };
+    juce::AudioParameterChoice* linkGroups { nullptr };
+    std::array<juce::AudioParameterChoice*, Compressor1176::maxChannels> channelLinkGroups {};
+    juce::dsp::ProcessSpec preparedSpec { 0.0, 0, 0 };
+    int preparedOversampling = -1;
+    int preparedOversamplingFilter = -1;
+    bool preparedSplitRate = false;
+    int preparedBands = 1;
+    int preparedLookaheadSamples = 0;
+    bool preparedDoublePrecision = false;
+    std::vector<int> preparedLinkGroups;
+
+    void prepareCompressors();
+    std::vector<int> getLinkGroups() const;
+    int getLookaheadSamples() const;
+    template <typename SampleType>
+    void processCompressors (juce::AudioBuffer<SampleType>& buffer, bool hostBypassed);
+    template <typename SampleType>
+    void processBands (juce::AudioBuffer<SampleType>& buffer, bool hostBypassed);
+    float getBlockMinGain (int channel) const;
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+
     void updateState();
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SeventySixCompressorAudioProcessor)
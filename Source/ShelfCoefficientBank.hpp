@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Low (100 Hz) and high (8 kHz) shelf coefficients for the GR-dependent
+// coloration, precomputed in prepare() over 0..maxBoostDb. The audio thread
+// blends the two nearest entries, so it neither allocates nor touches the
+// reference-counted juce::dsp::IIR::Coefficients.
+//
+// Designed, stored and run in double, even by the float engine: rounded to
+// float, the coefficients move the shelves' poles, which sit close to z = 1
+// at oversampled rates, far enough to shift the 100 Hz corner audibly.
+class ShelfCoefficientBank
+{
+	public:
+		// b0, b1, b2, a1, a2 (a0 normalised) for the low shelf, then the high shelf
+		static constexpr int numCoeffs = 10;
+		using Entry = std::array<double, numCoeffs>;
+
+		static constexpr float maxBoostDb = 1.0f;
+		static constexpr int stepsPerDb = 64;
+
+		void prepare(double sampleRate)
+		{
+			entries.resize(static_cast<size_t>(maxBoostDb * stepsPerDb) + 2);
+			for (size_t i = 0; i < entries.size(); ++i)
+			{
+				double gain = juce::Decibels::decibelsToGain(static_cast<double>(i) / stepsPerDb);
+				auto low = juce::dsp::IIR::Coefficients<double>::makeLowShelf(sampleRate, 100.0, 0.707, gain);
+				auto high = juce::dsp::IIR::Coefficients<double>::makeHighShelf(sampleRate, 8000.0, 0.707, gain);
+				for (int k = 0; k < 5; ++k)
+				{
+					entries[i][static_cast<size_t>(k)] = low->getRawCoefficients()[k];
+					entries[i][static_cast<size_t>(k) + 5] = high->getRawCoefficients()[k];
+				}
+			}
+		}
+
+		// Linearly blended coefficients for boostDb, clamped to 0..maxBoostDb
+		void lookup(double boostDb, double* coeffs) const noexcept
+		{
+			double position = std::clamp(boostDb, 0.0, static_cast<double>(maxBoostDb)) * stepsPerDb;
+			auto index = static_cast<size_t>(position);
+			double frac = position - static_cast<double>(index);
+			const Entry& a = entries[index];
+			const Entry& b = entries[index + 1];
+			for (int k = 0; k < numCoeffs; ++k)
+				coeffs[k] = a[static_cast<size_t>(k)] + frac * (b[static_cast<size_t>(k)] - a[static_cast<size_t>(k)]);
+		}
+
+	private:
+		std::vector<Entry> entries;
+};
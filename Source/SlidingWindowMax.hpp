@@ -0,0 +1,57 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Running maximum over the last `length` samples, as a monotonic deque in a
+// ring allocated by prepare(). Every sample is pushed once and popped at
+// most once, so the cost is amortised O(1) per sample whatever the length.
+template <typename SampleType>
+class SlidingWindowMax
+{
+	public:
+		void prepare(int newLength)
+		{
+			length = static_cast<uint32_t>(std::max(1, newLength));
+			values.assign(length + 1, SampleType());
+			indices.assign(length + 1, 0);
+			reset();
+		}
+
+		void reset()
+		{
+			head = 0;
+			size = 0;
+			counter = 0;
+		}
+
+		int getLength() const { return static_cast<int>(length); }
+
+		SampleType process(SampleType x) noexcept
+		{
+			// Older values no larger than x can never be the maximum again
+			while (size > 0 && values[wrap(head + size - 1)] <= x)
+				--size;
+			const uint32_t slot = wrap(head + size);
+			values[slot] = x;
+			indices[slot] = counter;
+			++size;
+
+			// Indices are pushed in order, so at most the front has expired
+			if (counter - indices[head] >= length)
+			{
+				head = wrap(head + 1);
+				--size;
+			}
+			++counter;
+			return values[head];
+		}
+
+	private:
+		uint32_t wrap(uint32_t slot) const noexcept { return slot > length ? slot - length - 1 : slot; }
+
+		std::vector<SampleType> values;
+		std::vector<uint32_t> indices;
+		uint32_t length = 1;
+		uint32_t head = 0;
+		uint32_t size = 0;
+		uint32_t counter = 0;
+};
@@ -0,0 +1,214 @@
+#include "SpectrumAnalyzer.hpp"
+
+// One thread for every active analyzer in the process; the FFT work follows
+// the number of open editors, not the number of plugin instances.
+class SpectrumAnalyzer::Worker : private juce::Thread
+{
+	public:
+		Worker() : juce::Thread("1176 Spectrum Analyzer") { startThread(); }
+		~Worker() override { stopThread(1000); }
+
+		void add(SpectrumAnalyzer* analyzer)
+		{
+			const juce::ScopedLock sl(lock);
+			analyzers.addIfNotAlreadyThere(analyzer);
+		}
+
+		void remove(SpectrumAnalyzer* analyzer)
+		{
+			const juce::ScopedLock sl(lock);
+			analyzers.removeFirstMatchingValue(analyzer);
+		}
+
+	private:
+		// The audio thread cannot signal us, so poll at roughly display rate
+		void run() override
+		{
+			while (!threadShouldExit())
+			{
+				{
+					const juce::ScopedLock sl(lock);
+					for (auto* analyzer : analyzers)
+						analyzer->processPending();
+				}
+				wait(15);
+			}
+		}
+
+		juce::CriticalSection lock;
+		juce::Array<SpectrumAnalyzer*> analyzers;
+};
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+	fftData.resize(2 * fftSize);
+	hop.resize(hopSize);
+	for (auto& spectrum : spectra)
+	{
+		spectrum.pre.fill(minDb);
+		spectrum.post.fill(minDb);
+	}
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+	setActive(false);
+}
+
+void SpectrumAnalyzer::prepare(double newSampleRate, int numChannels)
+{
+	const juce::ScopedLock sl(workerLock);
+	sampleRate = newSampleRate;
+	// Room for well over one worker poll at any rate
+	const int capacity = juce::nextPowerOfTwo(static_cast<int>(sampleRate * 0.1)) + 1;
+	pre.prepare(numChannels, capacity);
+	post.prepare(numChannels, capacity);
+
+	// Fractional FFT bin for every display point
+	const float maxFrequency = juce::jmin(20000.0f, static_cast<float>(sampleRate * 0.5));
+	for (int i = 0; i < numPoints; ++i)
+	{
+		const float frequency = minFrequency * std::pow(maxFrequency / minFrequency, i / static_cast<float>(numPoints - 1));
+		pointBins[static_cast<size_t>(i)] = juce::jlimit(0.0f, static_cast<float>(fftSize / 2 - 2), frequency * fftSize / static_cast<float>(sampleRate));
+	}
+	const juce::SpinLock::ScopedLockType spectrumSl(spectrumLock);
+	for (auto& spectrum : spectra)
+		spectrum.maxFrequency = maxFrequency;
+}
+
+void SpectrumAnalyzer::setActive(bool shouldBeActive)
+{
+	if (shouldBeActive == active.load())
+		return;
+	if (shouldBeActive)
+	{
+		worker = std::make_unique<juce::SharedResourcePointer<Worker>>();
+		(*worker)->add(this);
+		active.store(true);
+	}
+	else
+	{
+		active.store(false);
+		(*worker)->remove(this);
+		worker.reset();
+	}
+}
+
+bool SpectrumAnalyzer::pullSpectrum(Spectrum& destination)
+{
+	const juce::SpinLock::ScopedLockType sl(spectrumLock);
+	if (!spectrumFresh)
+		return false;
+	destination = spectra[static_cast<size_t>(frontSpectrum)];
+	spectrumFresh = false;
+	return true;
+}
+
+void SpectrumAnalyzer::Stream::prepare(int numChannels, int capacity)
+{
+	fifo.setTotalSize(capacity);
+	fifo.reset();
+	ring.setSize(numChannels, capacity);
+	history.assign(fftSize, 0.0f);
+	magnitudes.assign(fftSize / 2, 0.0f);
+}
+
+void SpectrumAnalyzer::Stream::push(const juce::AudioBuffer<float>& buffer) noexcept
+{
+	const int numChannels = juce::jmin(buffer.getNumChannels(), ring.getNumChannels());
+	// Whatever does not fit is dropped; the worker is behind anyway
+	const auto scope = fifo.write(buffer.getNumSamples());
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		if (scope.blockSize1 > 0)
+			ring.copyFrom(ch, scope.startIndex1, buffer, ch, 0, scope.blockSize1);
+		if (scope.blockSize2 > 0)
+			ring.copyFrom(ch, scope.startIndex2, buffer, ch, scope.blockSize1, scope.blockSize2);
+	}
+}
+
+void SpectrumAnalyzer::Stream::push(const juce::AudioBuffer<double>& buffer) noexcept
+{
+	const int numChannels = juce::jmin(buffer.getNumChannels(), ring.getNumChannels());
+	const auto scope = fifo.write(buffer.getNumSamples());
+	for (int ch = 0; ch < numChannels; ++ch)
+	{
+		const double* samples = buffer.getReadPointer(ch);
+		float* first = ring.getWritePointer(ch, scope.startIndex1);
+		float* second = ring.getWritePointer(ch, scope.startIndex2);
+		for (int i = 0; i < scope.blockSize1; ++i)
+			first[i] = static_cast<float>(samples[i]);
+		for (int i = 0; i < scope.blockSize2; ++i)
+			second[i] = static_cast<float>(samples[scope.blockSize1 + i]);
+	}
+}
+
+// Next hop, summed to mono
+bool SpectrumAnalyzer::Stream::popHop(float* mono)
+{
+	if (fifo.getNumReady() < hopSize)
+		return false;
+	const auto scope = fifo.read(hopSize);
+	juce::FloatVectorOperations::clear(mono, hopSize);
+	for (int ch = 0; ch < ring.getNumChannels(); ++ch)
+	{
+		juce::FloatVectorOperations::add(mono, ring.getReadPointer(ch, scope.startIndex1), scope.blockSize1);
+		juce::FloatVectorOperations::add(mono + scope.blockSize1, ring.getReadPointer(ch, scope.startIndex2), scope.blockSize2);
+	}
+	return true;
+}
+
+// Slides every complete hop into the stream's history and folds its frame
+// into the running magnitude average; false if no hop was waiting
+bool SpectrumAnalyzer::drain(Stream& stream)
+{
+	bool analysed = false;
+	while (stream.popHop(hop.data()))
+	{
+		std::move(stream.history.begin() + hopSize, stream.history.end(), stream.history.begin());
+		std::copy(hop.begin(), hop.end(), stream.history.end() - hopSize);
+
+		std::copy(stream.history.begin(), stream.history.end(), fftData.begin());
+		window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+		fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+		for (size_t bin = 0; bin < stream.magnitudes.size(); ++bin)
+			stream.magnitudes[bin] += (1.0f - averaging) * (fftData[bin] - stream.magnitudes[bin]);
+		analysed = true;
+	}
+	return analysed;
+}
+
+// A full-scale sine reads 0 dB: the Hann window halves the peak bin
+void SpectrumAnalyzer::toPoints(const Stream& stream, std::array<float, numPoints>& points) const
+{
+	constexpr float amplitudeScale = 4.0f / fftSize;
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		const float position = pointBins[i];
+		const auto bin = static_cast<size_t>(position);
+		const float frac = position - static_cast<float>(bin);
+		const float magnitude = stream.magnitudes[bin] + frac * (stream.magnitudes[bin + 1] - stream.magnitudes[bin]);
+		points[i] = juce::Decibels::gainToDecibels(magnitude * amplitudeScale, minDb);
+	}
+}
+
+void SpectrumAnalyzer::processPending()
+{
+	// prepare() holds this while it reallocates; skip a poll rather than wait
+	const juce::ScopedTryLock sl(workerLock);
+	if (!sl.isLocked())
+		return;
+
+	const bool preUpdated = drain(pre);
+	const bool postUpdated = drain(post);
+	if (!preUpdated && !postUpdated)
+		return;
+
+	Spectrum& back = spectra[static_cast<size_t>(1 - frontSpectrum)];
+	toPoints(pre, back.pre);
+	toPoints(post, back.post);
+
+	const juce::SpinLock::ScopedLockType spectrumSl(spectrumLock);
+	frontSpectrum = 1 - frontSpectrum;
+	spectrumFresh = true;
+}
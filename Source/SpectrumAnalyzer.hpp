@@ -0,0 +1,93 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Pre/post-compression spectrum for the editor.
+//
+// The audio thread only memcpys each block into a lock-free ring, and only
+// while an editor has the analyzer active. A worker thread, shared by every
+// instance in the process and alive only while at least one analyzer is
+// active, drains the rings in hops of fftSize / 4 (75% overlap), runs a
+// Hann-windowed FFT, averages the magnitudes and resamples them onto a
+// log-frequency axis. The result is published double-buffered; the editor
+// copies the front buffer under a lock the audio thread never takes.
+class SpectrumAnalyzer
+{
+	public:
+		static constexpr int fftOrder = 11;
+		static constexpr int fftSize = 1 << fftOrder;
+		static constexpr int hopSize = fftSize / 4;
+		static constexpr int numPoints = 256;
+		static constexpr float minFrequency = 20.0f;
+		static constexpr float minDb = -100.0f;
+		// Weight of the previous frames in the running magnitude average
+		static constexpr float averaging = 0.7f;
+
+		// dB per point, point i at minFrequency * (maxFrequency / minFrequency)^(i / (numPoints - 1))
+		struct Spectrum
+		{
+			std::array<float, numPoints> pre;
+			std::array<float, numPoints> post;
+			float maxFrequency = 20000.0f;
+		};
+
+		SpectrumAnalyzer();
+		~SpectrumAnalyzer();
+
+		// Message thread, audio stopped
+		void prepare(double sampleRate, int numChannels);
+
+		// Audio thread: copy only, and nothing at all with no editor open
+		template <typename SampleType>
+		void pushPre(const juce::AudioBuffer<SampleType>& buffer) noexcept { if (active.load(std::memory_order_relaxed)) pre.push(buffer); }
+		template <typename SampleType>
+		void pushPost(const juce::AudioBuffer<SampleType>& buffer) noexcept { if (active.load(std::memory_order_relaxed)) post.push(buffer); }
+
+		// Editor: start/stop analysing; and copy the newest spectrum, false if
+		// nothing was published since the last call
+		void setActive(bool shouldBeActive);
+		bool pullSpectrum(Spectrum& destination);
+
+	private:
+		class Worker;
+		friend class Worker;
+
+		// Multichannel SPSC sample ring: audio thread in, worker out
+		struct Stream
+		{
+			juce::AbstractFifo fifo { 1 };
+			juce::AudioBuffer<float> ring;
+			std::vector<float> history;
+			std::vector<float> magnitudes;
+
+			void prepare(int numChannels, int capacity);
+			void push(const juce::AudioBuffer<float>& buffer) noexcept;
+			// Narrowed to float on the way in; the display does not need more
+			void push(const juce::AudioBuffer<double>& buffer) noexcept;
+			bool popHop(float* mono);
+		};
+
+		// Worker thread: everything that arrived since the last call
+		void processPending();
+		bool drain(Stream& stream);
+		void toPoints(const Stream& stream, std::array<float, numPoints>& points) const;
+
+		Stream pre, post;
+		std::atomic<bool> active { false };
+		juce::CriticalSection workerLock;
+
+		juce::dsp::FFT fft { fftOrder };
+		juce::dsp::WindowingFunction<float> window { static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false };
+		std::vector<float> fftData;
+		std::vector<float> hop;
+		std::array<float, numPoints> pointBins {};
+		double sampleRate = 44100.0;
+
+		std::array<Spectrum, 2> spectra;
+		int frontSpectrum = 0;
+		bool spectrumFresh = false;
+		juce::SpinLock spectrumLock;
+
+		std::unique_ptr<juce::SharedResourcePointer<Worker>> worker;
+
+		JUCE_DECLARE_NON_COPYABLE(SpectrumAnalyzer)
+};
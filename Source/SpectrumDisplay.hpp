@@ -0,0 +1,71 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SpectrumAnalyzer.hpp"
+
+// Pre (grey) and post (white) compression spectra. Keeps the analyzer
+// active for as long as it exists, so the audio thread only copies samples
+// while a window is open.
+class SpectrumDisplay : public juce::Component
+{
+	public:
+		explicit SpectrumDisplay(SpectrumAnalyzer& analyzerToUse) : analyzer(analyzerToUse)
+		{
+			setOpaque(true);
+			spectrum.pre.fill(SpectrumAnalyzer::minDb);
+			spectrum.post.fill(SpectrumAnalyzer::minDb);
+			analyzer.setActive(true);
+		}
+
+		~SpectrumDisplay() override { analyzer.setActive(false); }
+
+		// Call once per display frame; repaints only when a new spectrum arrived
+		void update()
+		{
+			if (analyzer.pullSpectrum(spectrum))
+				repaint();
+		}
+
+		void paint(juce::Graphics& g) override
+		{
+			g.fillAll(juce::Colour(0xff151515));
+
+			g.setColour(juce::Colours::white.withAlpha(0.08f));
+			for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+			{
+				const float x = frequencyToX(frequency);
+				g.drawVerticalLine(juce::roundToInt(x), 0.0f, static_cast<float>(getHeight()));
+			}
+
+			g.setColour(juce::Colours::grey.withAlpha(0.6f));
+			g.strokePath(makePath(spectrum.pre), juce::PathStrokeType(1.0f));
+			g.setColour(juce::Colours::white.withAlpha(0.9f));
+			g.strokePath(makePath(spectrum.post), juce::PathStrokeType(1.0f));
+		}
+
+	private:
+		float frequencyToX(float frequency) const
+		{
+			const float span = std::log(spectrum.maxFrequency / SpectrumAnalyzer::minFrequency);
+			return getWidth() * std::log(frequency / SpectrumAnalyzer::minFrequency) / span;
+		}
+
+		juce::Path makePath(const std::array<float, SpectrumAnalyzer::numPoints>& points) const
+		{
+			juce::Path path;
+			const float width = static_cast<float>(getWidth());
+			const float height = static_cast<float>(getHeight());
+			for (size_t i = 0; i < points.size(); ++i)
+			{
+				const float x = width * static_cast<float>(i) / (points.size() - 1);
+				const float y = juce::jmap(points[i], SpectrumAnalyzer::minDb, 0.0f, height, 0.0f);
+				if (i == 0)
+					path.startNewSubPath(x, y);
+				else
+					path.lineTo(x, y);
+			}
+			return path;
+		}
+
+		SpectrumAnalyzer& analyzer;
+		SpectrumAnalyzer::Spectrum spectrum;
+};